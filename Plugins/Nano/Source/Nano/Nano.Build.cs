@@ -8,6 +8,8 @@ public class Nano : ModuleRules
 	{
 		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
 
+		// ed25519-donna is built once per backend (ed25519.c, ed25519-sse2.c and ed25519-32bit.c), nano/ed25519_backends.cpp
+		// picks one at startup
 		PublicDefinitions.Add("ED25519_CUSTOMRNG");
 		PublicDefinitions.Add("ED25519_CUSTOMHASH");
 
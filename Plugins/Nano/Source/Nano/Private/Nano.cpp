@@ -1,10 +1,42 @@
 // Copyright 2020 Wesley Shillingford. All rights reserved.
 #include "Nano.h"
 
+#include "Misc/CommandLine.h"
+#include "Misc/ConfigCacheIni.h"
+
+#include <nano/ed25519_backends.h>
+
 #define LOCTEXT_NAMESPACE "FNanoModule"
 
 void FNanoModule::StartupModule() {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+
+	// Signing backend: -NanoEd25519=<name> on the command line, then Ed25519Backend under [Nano] in the engine ini, otherwise
+	// whichever signs fastest on this machine
+	FString name;
+	if (!FParse::Value(FCommandLine::Get(), TEXT("NanoEd25519="), name)) {
+		GConfig->GetString(TEXT("Nano"), TEXT("Ed25519Backend"), name, GEngineIni);
+	}
+
+	nano::ed25519_backend backend;
+	if (!name.IsEmpty() && !nano::ed25519_backend_from_name(TCHAR_TO_UTF8(*name), backend)) {
+		nano::ed25519_select(backend);
+		UE_LOG(LogTemp, Log, TEXT("Nano ed25519 backend: %s (configured)"), *name);
+		return;
+	}
+
+	if (!name.IsEmpty()) {
+		UE_LOG(LogTemp, Warning, TEXT("Nano ed25519 backend %s is not available, benchmarking instead"), *name);
+	}
+
+	auto rates = nano::ed25519_select_fastest();
+	for (size_t i = 0; i < rates.size(); ++i) {
+		if (rates[i] > 0) {
+			UE_LOG(LogTemp, Log, TEXT("Nano ed25519 %s: %.0f sign+verify/s"),
+				UTF8_TO_TCHAR(nano::ed25519_backend_name(static_cast<nano::ed25519_backend>(i))), rates[i]);
+		}
+	}
+	UE_LOG(LogTemp, Log, TEXT("Nano ed25519 backend: %s"), UTF8_TO_TCHAR(nano::ed25519_backend_name(nano::ed25519_selected())));
 }
 
 void FNanoModule::ShutdownModule() {
@@ -14,4 +46,4 @@ void FNanoModule::ShutdownModule() {
 
 #undef LOCTEXT_NAMESPACE
 
-IMPLEMENT_MODULE(FNanoModule, Nano)
\ No newline at end of file
+IMPLEMENT_MODULE(FNanoModule, Nano)
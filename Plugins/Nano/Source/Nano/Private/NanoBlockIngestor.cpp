@@ -0,0 +1,412 @@
+// Copyright 2020 Wesley Shillingford. All rights reserved.
+#include "NanoBlockIngestor.h"
+
+#include "Async/Async.h"
+#include "HAL/PlatformTime.h"
+#include "Json.h"
+
+#include <nano/numbers.h>
+#include <nano/work.h>
+
+#include <vector>
+
+void UNanoBlockIngestor::Submit(FIngestResponseReceivedDelegate delegate, FIngestBlock block) {
+	check(manager);
+
+	Item item;
+	item.delegate = delegate;
+	item.stageStart = FPlatformTime::Seconds();
+	if (Decode(block, item)) {
+		Reject(item, FIngestStage::decode, TEXT("Invalid block"));
+		return;
+	}
+
+	// Hashed from the decoded fields rather than trusting a hash from the client
+	item.hash = item.block.hash();
+	Pass(item, FIngestStage::decode);
+	QueueVerify(MoveTemp(item));
+}
+
+FIngestStageMetrics UNanoBlockIngestor::GetStageMetrics(FIngestStage stage) const {
+	FIngestStageMetrics metrics;
+	auto const& stageStats = stats[static_cast<size_t>(stage)];
+	metrics.passed = stageStats.passed;
+	metrics.rejected = stageStats.rejected;
+	auto count = stageStats.passed + stageStats.rejected;
+	metrics.averageLatencyMs = count > 0 ? static_cast<float>(stageStats.totalSeconds * 1000 / count) : 0.0f;
+
+	// Decoding and the work check are done straight away
+	switch (stage) {
+		case FIngestStage::verify:
+			metrics.queued = verifyQueue.Num() + verifying;
+			break;
+		case FIngestStage::frontier:
+			metrics.queued = lookupQueue.Num() + lookingUp;
+			break;
+		case FIngestStage::process:
+			metrics.queued = processQueue.Num() + processing;
+			break;
+		default:
+			break;
+	}
+	return metrics;
+}
+
+void UNanoBlockIngestor::Pass(Item& item, FIngestStage stage) {
+	auto now = FPlatformTime::Seconds();
+	auto& stageStats = stats[static_cast<size_t>(stage)];
+	++stageStats.passed;
+	stageStats.totalSeconds += now - item.stageStart;
+	item.stageStart = now;
+}
+
+void UNanoBlockIngestor::Reject(Item& item, FIngestStage stage, FString const& message) {
+	auto& stageStats = stats[static_cast<size_t>(stage)];
+	++stageStats.rejected;
+	stageStats.totalSeconds += FPlatformTime::Seconds() - item.stageStart;
+
+	FIngestResponseData data;
+	data.hash = item.hash.to_string().c_str();
+	data.stage = stage;
+	data.errorMessage = message;
+	data.error = true;
+	item.delegate.ExecuteIfBound(data);
+}
+
+bool UNanoBlockIngestor::Decode(FIngestBlock const& block, Item& item) const {
+	auto& hashables = item.block.hashables;
+	FTCHARToUTF8 previous(*block.previous);
+	FTCHARToUTF8 balance(*block.balance);
+	FTCHARToUTF8 link(*block.link);
+	FTCHARToUTF8 signature(*block.signature);
+	FTCHARToUTF8 work(*block.work);
+	// The link of a send is often written as the destination account
+	return manager->DecodeAccount(block.account, hashables.account) ||
+				 manager->DecodeAccount(block.representative, hashables.representative) ||
+				 hashables.previous.decode_hex(previous.Get(), previous.Length()) ||
+				 hashables.balance.decode_dec_n(balance.Get(), balance.Length()) ||
+				 (hashables.link.decode_hex(link.Get(), link.Length()) && manager->DecodeAccount(block.link, hashables.link)) ||
+				 item.signature.decode_hex(signature.Get(), signature.Length()) ||
+				 nano::decode_work(work.Get(), work.Length(), item.work);
+}
+
+void UNanoBlockIngestor::QueueVerify(Item&& item) {
+	verifyQueue.Add(MoveTemp(item));
+	if (verifyQueue.Num() >= static_cast<int32>(nano::signature_batch_size)) {
+		Verify();
+	} else if (verifyQueue.Num() == 1) {
+		// Give the rest of the blocks submitted this frame a chance to join the batch
+		TWeakObjectPtr<UNanoBlockIngestor> weakThis(this);
+		AsyncTask(ENamedThreads::GameThread, [weakThis]() {
+			if (weakThis.IsValid()) {
+				weakThis->Verify();
+			}
+		});
+	}
+}
+
+void UNanoBlockIngestor::Verify() {
+	// One batch at a time keeps blocks in the order they were submitted, later blocks of an account depend on earlier ones
+	if (verifying > 0 || verifyQueue.Num() == 0) {
+		return;
+	}
+
+	verifying += verifyQueue.Num();
+	TWeakObjectPtr<UNanoBlockIngestor> weakThis(this);
+	Async(EAsyncExecution::ThreadPool, [weakThis, batch = MoveTemp(verifyQueue)]() mutable {
+		std::vector<nano::block_hash> hashes;
+		std::vector<nano::account> accounts;
+		std::vector<nano::signature> signatures;
+		for (auto const& item : batch) {
+			hashes.push_back(item.hash);
+			accounts.push_back(item.block.hashables.account);
+			signatures.push_back(item.signature);
+		}
+		auto valid = nano::validate_signatures(hashes, accounts, signatures);
+
+		AsyncTask(ENamedThreads::GameThread, [weakThis, batch = MoveTemp(batch), valid = MoveTemp(valid)]() mutable {
+			if (!weakThis.IsValid()) {
+				return;
+			}
+			auto ingestor = weakThis.Get();
+			ingestor->verifying -= batch.Num();
+			for (auto i = 0; i < batch.Num(); ++i) {
+				auto& item = batch[i];
+				if (!valid[i]) {
+					ingestor->Reject(item, FIngestStage::verify, TEXT("Invalid signature"));
+					continue;
+				}
+				ingestor->Pass(item, FIngestStage::verify);
+
+				// Only the lowest threshold is known until the lookup shows whether this is a send or a receive
+				auto const& hashables = item.block.hashables;
+				item.difficulty = nano::work_value(hashables.previous.is_zero() ? hashables.account : hashables.previous, item.work);
+				if (item.difficulty < nano::work_thresholds::epoch_2_receive) {
+					ingestor->Reject(item, FIngestStage::work, TEXT("Insufficient work"));
+					continue;
+				}
+				ingestor->Pass(item, FIngestStage::work);
+				ingestor->lookupQueue.Add(MoveTemp(item));
+			}
+			ingestor->Verify();
+			ingestor->Lookup();
+		});
+	});
+	verifyQueue.Reset();
+}
+
+void UNanoBlockIngestor::Lookup() {
+	// One lookup at a time, so the blocks accepted from one batch are in accepted before the next batch is checked
+	if (lookingUp > 0 || lookupQueue.Num() == 0) {
+		return;
+	}
+
+	auto count = FMath::Min(lookupQueue.Num(), FMath::Max(maxLookupBatch, 1));
+	auto lookup = MakeShared<LookupState>();
+	lookup->batch.Reserve(count);
+	for (auto i = 0; i < count; ++i) {
+		lookup->batch.Add(MoveTemp(lookupQueue[i]));
+	}
+	lookupQueue.RemoveAt(0, count);
+	lookingUp = count;
+
+	for (auto const& item : lookup->batch) {
+		if (lookup->states.emplace(item.block.hashables.account).second) {
+			lookup->accounts.push_back(item.block.hashables.account);
+		}
+	}
+
+	// Pending is read before the frontier, a receive processed in between leaves it too large rather than too small so a valid
+	// receive is never rejected for it
+	auto writer = manager->RequestWriter();
+	nano::rpc::accounts(writer, "accounts_balances", lookup->accounts.data(), lookup->accounts.size(), false);
+	TWeakObjectPtr<UNanoBlockIngestor> weakThis(this);
+	manager->MakeRequest(manager->requestContent, [weakThis, lookup](TSharedPtr<FJsonObject> const& response) {
+		if (!weakThis.IsValid()) {
+			return;
+		}
+		auto ingestor = weakThis.Get();
+		if (!response || response->HasField("error")) {
+			ingestor->FailLookup(*lookup);
+			return;
+		}
+
+		auto balances = ingestor->manager->ResultsByKey(response, TEXT("balances"), false);
+		for (auto const& account : lookup->accounts) {
+			auto balance = balances.find(account);
+			TSharedPtr<FJsonObject> const* object;
+			if (balance && (*balance)->TryGetObject(object)) {
+				FTCHARToUTF8 pending(*(*object)->GetStringField(TEXT("pending")));
+				lookup->states.find(account)->pending.decode_dec_n(pending.Get(), pending.Length());
+			}
+		}
+		ingestor->LookupFrontiers(lookup);
+	});
+}
+
+void UNanoBlockIngestor::LookupFrontiers(TSharedRef<LookupState> const& lookup) {
+	auto writer = manager->RequestWriter();
+	nano::rpc::accounts(writer, "accounts_frontiers", lookup->accounts.data(), lookup->accounts.size(), false);
+	TWeakObjectPtr<UNanoBlockIngestor> weakThis(this);
+	manager->MakeRequest(manager->requestContent, [weakThis, lookup](TSharedPtr<FJsonObject> const& response) {
+		if (!weakThis.IsValid()) {
+			return;
+		}
+		auto ingestor = weakThis.Get();
+		if (!response || response->HasField("error")) {
+			ingestor->FailLookup(*lookup);
+			return;
+		}
+
+		// Unopened accounts are missing from the frontiers and have no balance
+		auto frontiers = ingestor->manager->ResultsByKey(response, TEXT("frontiers"), false);
+		std::vector<nano::block_hash> hashes;
+		for (auto const& account : lookup->accounts) {
+			auto frontier = frontiers.find(account);
+			if (frontier) {
+				auto state = lookup->states.find(account);
+				FTCHARToUTF8 text(*(*frontier)->AsString());
+				if (state->frontier.decode_hex(text.Get(), text.Length())) {
+					lookup->states.erase(account);
+				} else {
+					hashes.push_back(state->frontier);
+				}
+			}
+		}
+
+		if (hashes.empty()) {
+			ingestor->CheckFrontiers(*lookup);
+		} else {
+			ingestor->LookupFrontierBlocks(lookup, hashes);
+		}
+	});
+}
+
+void UNanoBlockIngestor::LookupFrontierBlocks(TSharedRef<LookupState> const& lookup, std::vector<nano::block_hash> const& frontiers) {
+	auto writer = manager->RequestWriter();
+	nano::rpc::blocks_info(writer, frontiers.data(), frontiers.size());
+	TWeakObjectPtr<UNanoBlockIngestor> weakThis(this);
+	manager->MakeRequest(manager->requestContent, [weakThis, lookup](TSharedPtr<FJsonObject> const& response) {
+		if (!weakThis.IsValid()) {
+			return;
+		}
+		auto ingestor = weakThis.Get();
+		if (!response || response->HasField("error")) {
+			ingestor->FailLookup(*lookup);
+			return;
+		}
+
+		auto blocks = ingestor->manager->ResultsByKey(response, TEXT("blocks"), true);
+		for (auto const& account : lookup->accounts) {
+			auto state = lookup->states.find(account);
+			if (state && !state->frontier.is_zero()) {
+				auto block = blocks.find(state->frontier);
+				TSharedPtr<FJsonObject> const* object;
+				FString balance;
+				auto found = block && (*block)->TryGetObject(object) && (*object)->TryGetStringField(TEXT("balance"), balance);
+				FTCHARToUTF8 text(*balance);
+				if (!found || state->balance.decode_dec_n(text.Get(), text.Length())) {
+					// The frontier block has gone, the account changed since the frontier was read
+					lookup->states.erase(account);
+				}
+			}
+		}
+		ingestor->CheckFrontiers(*lookup);
+	});
+}
+
+void UNanoBlockIngestor::FailLookup(LookupState& lookup) {
+	lookingUp = 0;
+	for (auto& item : lookup.batch) {
+		Reject(item, FIngestStage::frontier, TEXT("Account lookup failed"));
+	}
+	ForgetProcessed();
+	Lookup();
+}
+
+void UNanoBlockIngestor::CheckFrontiers(LookupState& lookup) {
+	lookingUp = 0;
+	for (auto& item : lookup.batch) {
+		auto const& hashables = item.block.hashables;
+		// Blocks accepted earlier, still queued or in flight, are ahead of what the node returned
+		auto acceptedState = accepted.find(hashables.account);
+		auto state = acceptedState ? &acceptedState->state : lookup.states.find(hashables.account);
+		if (!state) {
+			Reject(item, FIngestStage::frontier, TEXT("Account lookup failed"));
+			continue;
+		}
+
+		if (hashables.previous != state->frontier) {
+			Reject(item, FIngestStage::frontier, TEXT("Previous is not the account's frontier"));
+			continue;
+		}
+
+		auto received = hashables.balance.number() > state->balance.number();
+		if (received && hashables.balance.number() - state->balance.number() > state->pending.number()) {
+			Reject(item, FIngestStage::frontier, TEXT("Receives more than is pending"));
+			continue;
+		}
+
+		// Now the subtype is known, sends and changes need more work than receives
+		if (!received && item.difficulty < nano::work_thresholds::epoch_2) {
+			Reject(item, FIngestStage::work, TEXT("Insufficient work"));
+			continue;
+		}
+
+		item.before = *state;
+		auto next = *state;
+		if (received) {
+			next.pending = state->pending.number() - (hashables.balance.number() - state->balance.number());
+		}
+		next.balance = hashables.balance;
+		next.frontier = item.hash;
+		auto& entry = *accepted.emplace(hashables.account).first;
+		entry.state = next;
+		++entry.unprocessed;
+
+		Pass(item, FIngestStage::frontier);
+		processQueue.Add(MoveTemp(item));
+	}
+	ForgetProcessed();
+	Process();
+	Lookup();
+}
+
+void UNanoBlockIngestor::ForgetProcessed() {
+	if (lookingUp > 0) {
+		return;
+	}
+	std::vector<nano::account> processed;
+	accepted.for_each([&processed](nano::account const& account, AcceptedState const& state) {
+		if (state.unprocessed == 0) {
+			processed.push_back(account);
+		}
+	});
+	for (auto const& account : processed) {
+		accepted.erase(account);
+	}
+}
+
+void UNanoBlockIngestor::Processed(Item& item, bool error) {
+	--processing;
+	auto const& account = item.block.hashables.account;
+	processingAccounts.erase(account);
+
+	auto acceptedState = accepted.find(account);
+	if (error) {
+		// The account's queued blocks all build on this one
+		for (auto i = 0; i < processQueue.Num();) {
+			if (processQueue[i].block.hashables.account == account) {
+				auto queued = MoveTemp(processQueue[i]);
+				processQueue.RemoveAt(i);
+				Reject(queued, FIngestStage::process, TEXT("Previous block was rejected"));
+			} else {
+				++i;
+			}
+		}
+		if (acceptedState) {
+			acceptedState->state = item.before;
+			acceptedState->unprocessed = 0;
+		}
+	} else if (acceptedState) {
+		--acceptedState->unprocessed;
+	}
+	ForgetProcessed();
+
+	if (error) {
+		Reject(item, FIngestStage::process, TEXT("Rejected by the node"));
+	} else {
+		Pass(item, FIngestStage::process);
+		FIngestResponseData data;
+		data.hash = item.hash.to_string().c_str();
+		item.delegate.ExecuteIfBound(data);
+	}
+	Process();
+}
+
+void UNanoBlockIngestor::Process() {
+	for (auto i = 0; i < processQueue.Num() && processing < FMath::Max(maxConcurrentProcess, 1);) {
+		if (processingAccounts.find(processQueue[i].block.hashables.account)) {
+			// Has to wait for the account's previous block
+			++i;
+			continue;
+		}
+
+		auto item = MoveTemp(processQueue[i]);
+		processQueue.RemoveAt(i);
+		processingAccounts.emplace(item.block.hashables.account);
+		++processing;
+
+		auto writer = manager->RequestWriter();
+		nano::rpc::process(writer, item.block.hashables, item.signature, item.work);
+
+		TWeakObjectPtr<UNanoBlockIngestor> weakThis(this);
+		manager->SendRequest(manager->requestContent,
+			[weakThis, item = MoveTemp(item)](TSharedPtr<FJsonObject> const& response) mutable {
+				if (!weakThis.IsValid()) {
+					return;
+				}
+				weakThis->Processed(item, UNanoManager::GetProcessResponseData(response).error);
+			});
+	}
+}
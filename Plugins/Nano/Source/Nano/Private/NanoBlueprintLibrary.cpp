@@ -1,6 +1,7 @@
 // Copyright 2020 Wesley Shillingford. All rights reserved.
 #include "NanoBlueprintLibrary.h"
 
+#include "Async/ParallelFor.h"
 #include "Engine/Texture2D.h"
 #include "HAL/FileManagerGeneric.h"
 #include "IImageWrapper.h"
@@ -8,8 +9,7 @@
 #include "Misc/AES.h"
 #include "Modules/ModuleManager.h"
 
-#include <baseconverter/base_converter.hpp>
-#include <duthomhas/csprng.hpp>
+#include <array>
 #include <cctype>
 #include <memory>
 #include <qrcode/QrCode.hpp>
@@ -19,8 +19,10 @@
 #pragma warning(disable : 4804) /* '/': unsafe use of type 'bool' in operation warnings */
 #endif
 #include <blake2/blake2.h>
-#include <ed25519-donna/ed25519.h>
+#include <nano/ed25519_backends.h>
 #include <nano/numbers.h>
+#include <nano/random_pool.h>
+#include <nano/work.h>
 
 using namespace std::literals;
 
@@ -28,11 +30,32 @@ namespace {
 nano::public_key PrivateKeyToPublicKeyData(const FString& privateKey);
 nano::private_key SeedAccountPrvData(const FString& seed_f, int32 index);
 nano::public_key SeedAccountPubData(const FString& seed, int32 index);
+
+// Same as ValidateRaw, but keeps the number rather than parsing the string again
+nano::amount DecodeRaw(const FString& raw) {
+	FTCHARToUTF8 utf8(*raw);
+	nano::amount amount;
+	auto error = amount.decode_dec_n(utf8.Get(), utf8.Length(), true);
+	check(!error);
+	return amount;
+}
+
+// Returns true on error
+bool DecodeHex64(const FString& hex, uint64_t& value) {
+	FTCHARToUTF8 utf8(*hex);
+	return nano::decode_work(utf8.Get(), utf8.Length(), value);
+}
+
+FString EncodeRaw(nano::amount const& amount) {
+	std::array<char, 39> text;
+	auto length = amount.encode_dec(text);
+	return FString(static_cast<int32>(length), text.data());
+}
 }	 // namespace
 
 bool UNanoBlueprintLibrary::ValidateRaw(FString raw) {
-	// Rudimentary check... it could still be above the largest raw value at 39 digits but shouldn't be a problem
-	if (raw.Len() > 39 || raw.IsEmpty()) {
+	// The length is checked by decode_dec after any leading zeroes
+	if (raw.IsEmpty()) {
 		return false;
 	}
 
@@ -41,9 +64,9 @@ bool UNanoBlueprintLibrary::ValidateRaw(FString raw) {
 	auto valid = str.end() == std::find_if(str.begin(), str.end(), [](unsigned char c) { return !isdigit(c); });
 
 	if (valid) {
-		nano::uint256_t num(BaseConverter::DecimalToHexConverter().Convert((TCHAR_TO_UTF8(*raw))).c_str());
-		valid =
-			(num <= nano::uint256_t(BaseConverter::DecimalToHexConverter().Convert("340282366920938463463374607431768211455").c_str()));
+		// Anything above the maximum 128-bit value overflows
+		nano::amount num;
+		valid = !num.decode_dec(str, true);
 	}
 	return valid;
 }
@@ -91,10 +114,13 @@ bool UNanoBlueprintLibrary::ValidateNano(FString nano) {
 
 		auto as_int = FCString::Atoi(*integer_part);
 		error = as_int > 340'282'366;	 // This is the maximum amount of Nano there is
-		if (!error) {
-			nano::uint128_t max(BaseConverter::DecimalToHexConverter().Convert("920938463463374607431768211456").c_str());
-			nano::uint128_t num(BaseConverter::DecimalToHexConverter().Convert((TCHAR_TO_UTF8(*fraction_part))).c_str());
-			error = num > max;
+		if (!error && !fraction_part.IsEmpty()) {
+			nano::amount max;
+			max.decode_dec("920938463463374607431768211456");
+			nano::amount num;
+			FTCHARToUTF8 fraction(*fraction_part);
+			// 1 Nano is 10^30 raw, so no more than 30 fractional digits
+			error = fraction_part.Len() > 30 || num.decode_dec_n(fraction.Get(), fraction.Length(), true) || num > max;
 		}
 	}
 
@@ -158,55 +184,90 @@ FString UNanoBlueprintLibrary::RawToNano(FString raw) {
 
 UFUNCTION(BlueprintCallable, Category = "Nano")
 FString UNanoBlueprintLibrary::Add(FString raw1, FString raw2) {
-	check(ValidateRaw(raw1) && ValidateRaw(raw2));
-
-	nano::amount amount1;
-	amount1.decode_dec(TCHAR_TO_UTF8(*raw1));
+	return EncodeRaw(DecodeRaw(raw1).number() + DecodeRaw(raw2).number());
+}
 
-	nano::amount amount2;
-	amount2.decode_dec(TCHAR_TO_UTF8(*raw2));
+UFUNCTION(BlueprintCallable, Category = "Nano")
+FString UNanoBlueprintLibrary::Subtract(FString raw1, FString raw2) {
+	auto amount1 = DecodeRaw(raw1);
+	auto amount2 = DecodeRaw(raw2);
+	check(!(amount1 < amount2));
+	return EncodeRaw(amount1.number() - amount2.number());
+}
 
-	nano::amount total = (amount1.number() + amount2.number());
-	return total.to_string_dec().c_str();
+UFUNCTION(BlueprintCallable, Category = "Nano")
+bool UNanoBlueprintLibrary::Greater(FString raw, FString baseRaw) {
+	return DecodeRaw(raw) > DecodeRaw(baseRaw);
 }
 
 UFUNCTION(BlueprintCallable, Category = "Nano")
-FString UNanoBlueprintLibrary::Subtract(FString raw1, FString raw2) {
-	check(GreaterOrEqual(raw1, raw2));
-	nano::amount amount1;
-	amount1.decode_dec(TCHAR_TO_UTF8(*raw1));
+bool UNanoBlueprintLibrary::GreaterOrEqual(FString raw, FString baseRaw) {
+	return !(DecodeRaw(raw) < DecodeRaw(baseRaw));
+}
 
-	nano::amount amount2;
-	amount2.decode_dec(TCHAR_TO_UTF8(*raw2));
+FNanoAmount UNanoBlueprintLibrary::AmountFromRaw(const FString& raw) {
+	return FNanoAmount::FromRaw(raw);
+}
 
-	check(amount2 < amount1);
+FString UNanoBlueprintLibrary::AmountToRaw(const FNanoAmount& amount) {
+	return amount.ToRaw();
+}
 
-	nano::amount total = (amount1.number() - amount2.number());
-	return total.to_string_dec().c_str();
+FNanoAmount UNanoBlueprintLibrary::Add_AmountAmount(const FNanoAmount& a, const FNanoAmount& b) {
+	return a + b;
 }
 
-UFUNCTION(BlueprintCallable, Category = "Nano")
-bool UNanoBlueprintLibrary::Greater(FString raw, FString baseRaw) {
-	check(ValidateRaw(raw) && ValidateRaw(baseRaw));
-	nano::amount amount1;
-	amount1.decode_dec(TCHAR_TO_UTF8(*raw));
+FNanoAmount UNanoBlueprintLibrary::Subtract_AmountAmount(const FNanoAmount& a, const FNanoAmount& b) {
+	check(a >= b);
+	return a - b;
+}
 
-	nano::amount amount2;
-	amount2.decode_dec(TCHAR_TO_UTF8(*baseRaw));
+bool UNanoBlueprintLibrary::EqualEqual_AmountAmount(const FNanoAmount& a, const FNanoAmount& b) {
+	return a == b;
+}
 
-	return amount1 > amount2;
+bool UNanoBlueprintLibrary::Greater_AmountAmount(const FNanoAmount& a, const FNanoAmount& b) {
+	return a > b;
 }
 
-UFUNCTION(BlueprintCallable, Category = "Nano")
-bool UNanoBlueprintLibrary::GreaterOrEqual(FString raw, FString baseRaw) {
-	check(ValidateRaw(raw) && ValidateRaw(baseRaw));
-	nano::amount amount1;
-	amount1.decode_dec(TCHAR_TO_UTF8(*raw));
+bool UNanoBlueprintLibrary::GreaterEqual_AmountAmount(const FNanoAmount& a, const FNanoAmount& b) {
+	return a >= b;
+}
+
+bool UNanoBlueprintLibrary::Less_AmountAmount(const FNanoAmount& a, const FNanoAmount& b) {
+	return a < b;
+}
+
+bool UNanoBlueprintLibrary::LessEqual_AmountAmount(const FNanoAmount& a, const FNanoAmount& b) {
+	return a <= b;
+}
+
+FNanoAmount UNanoBlueprintLibrary::SumAmounts(const TArray<FNanoAmount>& amounts) {
+	FNanoAmount total;
+	for (auto const& amount : amounts) {
+		total = total + amount;
+	}
+	return total;
+}
 
-	nano::amount amount2;
-	amount2.decode_dec(TCHAR_TO_UTF8(*baseRaw));
+FNanoAmount UNanoBlueprintLibrary::MinAmount(const TArray<FNanoAmount>& amounts, int32& index) {
+	index = amounts.Num() > 0 ? 0 : -1;
+	for (auto i = 1; i < amounts.Num(); ++i) {
+		if (amounts[i] < amounts[index]) {
+			index = i;
+		}
+	}
+	return index != -1 ? amounts[index] : FNanoAmount();
+}
 
-	return amount1 == amount2 || amount1 > amount2;
+FNanoAmount UNanoBlueprintLibrary::MaxAmount(const TArray<FNanoAmount>& amounts, int32& index) {
+	index = amounts.Num() > 0 ? 0 : -1;
+	for (auto i = 1; i < amounts.Num(); ++i) {
+		if (amounts[i] > amounts[index]) {
+			index = i;
+		}
+	}
+	return index != -1 ? amounts[index] : FNanoAmount();
 }
 
 UFUNCTION(BlueprintCallable, Category = "Nano")
@@ -220,11 +281,54 @@ FString UNanoBlueprintLibrary::ConvertnanoToRaw(FString nano_f) {
 	return new_amount.to_string_dec().c_str();
 }
 
+UFUNCTION(BlueprintCallable, Category = "Nano")
+bool UNanoBlueprintLibrary::ValidateWork(FString root, FString work, FString difficulty) {
+	FTCHARToUTF8 rootText(*root);
+	nano::block_hash hash;
+	uint64_t workValue;
+	uint64_t threshold;
+	return !hash.decode_hex(rootText.Get(), rootText.Length()) && !DecodeHex64(work, workValue) &&
+				 !DecodeHex64(difficulty, threshold) && !nano::work_validate(hash, workValue, threshold);
+}
+
+UFUNCTION(BlueprintCallable, Category = "Nano")
+TArray<bool> UNanoBlueprintLibrary::ValidateWorkBatch(const TArray<FString>& roots, const TArray<FString>& works, FString difficulty) {
+	check(roots.Num() == works.Num());
+	TArray<bool> valid;
+	valid.Init(false, roots.Num());
+
+	uint64_t threshold;
+	if (DecodeHex64(difficulty, threshold)) {
+		return valid;
+	}
+
+	// Anything which doesn't parse stays invalid, the rest are checked together
+	std::vector<nano::block_hash> parsedRoots;
+	std::vector<uint64_t> parsedWorks;
+	std::vector<int32> indices;
+	for (auto i = 0; i < roots.Num(); ++i) {
+		FTCHARToUTF8 root(*roots[i]);
+		nano::block_hash hash;
+		uint64_t work;
+		if (!hash.decode_hex(root.Get(), root.Length()) && !DecodeHex64(works[i], work)) {
+			parsedRoots.push_back(hash);
+			parsedWorks.push_back(work);
+			indices.push_back(i);
+		}
+	}
+
+	std::unique_ptr<bool[]> errors(new bool[indices.size()]);
+	nano::work_validate(parsedRoots.data(), parsedWorks.data(), indices.size(), threshold, errors.get());
+	for (size_t i = 0; i < indices.size(); ++i) {
+		valid[indices[i]] = !errors[i];
+	}
+	return valid;
+}
+
 UFUNCTION(BlueprintCallable, Category = "Nano")
 FString UNanoBlueprintLibrary::CreateSeed() {
-	duthomhas::csprng rng;
 	nano::uint256_union seed;
-	rng(seed.bytes);
+	nano::random_pool::generate(seed.bytes);
 	return FString(seed.to_string().c_str());
 }
 
@@ -254,10 +358,54 @@ FString UNanoBlueprintLibrary::AccountFromSeed(FString seed, int32 index) {
 	return SeedAccountPubData(seed, index).to_account().c_str();
 }
 
+UFUNCTION(BlueprintCallable, Category = "Nano")
+FSeedAccountsData UNanoBlueprintLibrary::AccountsFromSeedRange(FString seed_f, int32 start, int32 count) {
+	// Each index keeps three strings of up to 65 characters, past this a single call would take gigabytes
+	constexpr int32 maxCount = 1 << 20;
+
+	FSeedAccountsData data;
+	data.start = start;
+
+	FTCHARToUTF8 seedText(*seed_f);
+	nano::uint256_union seed;
+	if (seed.decode_hex(seedText.Get(), seedText.Length()) || start < 0 || count <= 0 || count > maxCount ||
+		count > MAX_int32 - start) {
+		return data;
+	}
+
+	data.privateKeys.SetNum(count);
+	data.publicKeys.SetNum(count);
+	data.accounts.SetNum(count);
+
+	// Keys and account checksums are hashed several at a time by blake2b_many, the public key multiplication dominates the rest
+	constexpr auto chunkSize = 256;
+	ParallelFor((count + chunkSize - 1) / chunkSize, [&](int32 chunk) {
+		auto first = chunk * chunkSize;
+		auto size = FMath::Min(chunkSize, count - first);
+		std::array<nano::private_key, chunkSize> privateKeys;
+		std::array<nano::public_key, chunkSize> publicKeys;
+		std::array<std::array<char, 65>, chunkSize> accounts;
+		nano::deterministic_keys(seed, static_cast<uint32_t>(start + first), size, privateKeys.data());
+		for (auto i = 0; i < size; ++i) {
+			nano::ed25519().publickey(privateKeys[i].bytes.data(), publicKeys[i].bytes.data());
+		}
+		nano::encode_accounts(publicKeys.data(), size, accounts.data());
+		for (auto i = 0; i < size; ++i) {
+			std::array<char, 64> hex;
+			privateKeys[i].encode_hex(hex);
+			data.privateKeys[first + i] = FString(static_cast<int32>(hex.size()), hex.data());
+			publicKeys[i].encode_hex(hex);
+			data.publicKeys[first + i] = FString(static_cast<int32>(hex.size()), hex.data());
+			data.accounts[first + i] = FString(static_cast<int32>(accounts[i].size()), accounts[i].data());
+		}
+	});
+	return data;
+}
+
 UFUNCTION(BlueprintCallable, Category = "Nano")
 FString UNanoBlueprintLibrary::PublicKeyFromAccount(FString account_f) {
 	std::string account_str(TCHAR_TO_UTF8(*account_f));
-	nano::account account;
+	nano::account account{};	// Left as zero if the account is invalid
 	account.decode_account(account_str);
 	return account.to_string().c_str();
 }
@@ -475,7 +623,7 @@ namespace {
 nano::public_key PrivateKeyToPublicKeyData(const FString& privateKey_f) {
 	nano::private_key privateKey(TCHAR_TO_UTF8(*privateKey_f));
 	nano::public_key publicKey;
-	ed25519_publickey(privateKey.bytes.data(), publicKey.bytes.data());
+	nano::ed25519().publickey(privateKey.bytes.data(), publicKey.bytes.data());
 	return publicKey;
 }
 
@@ -490,7 +638,7 @@ nano::private_key SeedAccountPrvData(const FString& seed_f, int32 index) {
 nano::public_key SeedAccountPubData(const FString& seed, int32 index) {
 	auto private_key = SeedAccountPrvData(seed, index);
 	nano::public_key publicKey;
-	ed25519_publickey(private_key.bytes.data(), publicKey.bytes.data());
+	nano::ed25519().publickey(private_key.bytes.data(), publicKey.bytes.data());
 	return publicKey;
 }
 }	 // namespace
@@ -1,6 +1,7 @@
 // Copyright 2020 Wesley Shillingford. All rights reserved.
 #include "NanoManager.h"
 
+#include "Async/Async.h"
 #include "Engine.h"
 #include "Engine/World.h"
 #include "Http.h"
@@ -9,11 +10,12 @@
 #include "JsonObjectConverter.h"
 #include "NanoBlueprintLibrary.h"
 
+#include <blake2/blake2.h>
 #include <ed25519-donna/ed25519.h>
 #include <nano/blocks.h>
 #include <nano/numbers.h>
-
-#include <baseconverter/base_converter.hpp>
+#include <nano/work.h>
+#include <nano/work_cache.h>
 
 #if PLATFORM_WINDOWS
 #include <shlobj.h>
@@ -25,61 +27,126 @@
 
 // clang-format off
 #define RETURN_ERROR_IF_INVALID_RESPONSE(Data) \
-	if (!RequestResponseIsValid (request, response, wasSuccessful)) { \
-		Data.error = true; \
-		return Data; \
-	} \
-\
-	auto reqRespJson = GetResponseJson(request, response, wasSuccessful); \
-	if (reqRespJson.response->HasField("error")) { \
+	if (!response || response->HasField("error")) { \
 		Data.error = true; \
 		return Data; \
 	}
 // clang-format on
 
 namespace {
+// Kept in the data path next to the seed files
+const TCHAR* WorkCacheFileName = TEXT("work_cache.bin");
+
+// Receives (and opens) only need 1/64 of the work of the other subtypes
+uint64_t BaseWorkThreshold(FSubtype subtype) {
+	if (subtype == FSubtype::receive || subtype == FSubtype::open) {
+		return nano::work_thresholds::epoch_2_receive;
+	}
+	return nano::work_thresholds::epoch_2;
+}
+
+// Work from the node or the cache isn't trusted, sets error if it is below threshold otherwise fills in what it reached
+void SetWorkDifficulty(FWorkGenerateResponseData& data, nano::block_hash const& root, uint64_t threshold) {
+	FTCHARToUTF8 text(*data.work);
+	uint64_t work = 0;
+	data.error = data.error || nano::decode_work(text.Get(), text.Length(), work) || nano::work_validate(root, work, threshold);
+	if (!data.error) {
+		auto difficulty = nano::work_value(root, work);
+		std::array<char, 16> difficultyText;
+		nano::encode_work(difficulty, difficultyText);
+		data.difficulty = FString(static_cast<int32>(difficultyText.size()), difficultyText.data());
+		data.multiplier = static_cast<float>(nano::work_multiplier(difficulty));
+	}
+}
+
 void fireAutomateDelegateError(FAutomateResponseReceivedDelegate delegate) {
 	FAutomateResponseData data;
 	data.error = true;
 	delegate.ExecuteIfBound(data);
 }
+
+// Decodes straight from the converted characters without going through std::string
+nano::uint256_union HexToKey(FString const& hex) {
+	FTCHARToUTF8 utf8(*hex);
+	nano::uint256_union key(0);
+	key.decode_hex(utf8.Get(), utf8.Length());
+	return key;
+}
+
+FString KeyAccount(nano::keyring::entry const& key) {
+	return FString(static_cast<int32>(key.account.size()), key.account.data());
+}
+
+void fireMakeBlockDelegateError(TFunction<void(FMakeBlockResponseData)> const& delegate) {
+	FMakeBlockResponseData makeBlockData;
+	makeBlockData.error = true;
+	delegate(makeBlockData);
+}
+
+FNanoAmount ToNanoAmount(nano::amount const& amount) {
+	auto value = amount.number();
+	return FNanoAmount(value.limbs[1], value.limbs[0]);
+}
+
+FString AmountToRaw(nano::amount const& amount) {
+	std::array<char, 39> text;
+	auto length = amount.encode_dec(text);
+	return FString(static_cast<int32>(length), text.data());
+}
+
+bool ParsePending(TArray<uint8> const& response, std::function<bool(nano::pending_entry const&)> const& visit) {
+	return nano::parse_pending(reinterpret_cast<char const*>(response.GetData()), response.Num(), visit);
+}
 }	 // namespace
 
+bool UNanoManager::DecodeAccount(FString const& account, nano::account& key) {
+	FTCHARToUTF8 utf8(*account);
+	return accounts.decode(utf8.Get(), utf8.Length(), key);
+}
+
+FString UNanoManager::EncodeAccount(nano::account const& key) {
+	std::array<char, 65> text;
+	accounts.encode(key, text);
+	return FString(static_cast<int32>(text.size()), text.data());
+}
+
 template <class T, class T1>
-void UNanoManager::RegisterBlockListener(std::string const& account, T const& responseData,
-	std::unordered_map<std::string, BlockListenerDelegate<T, T1>>& blockListener, T1 delegate) {
+void UNanoManager::RegisterBlockListener(nano::account const& account, T const& responseData,
+	nano::key_map<BlockListenerDelegate<T, T1>>& blockListener, T1 delegate) {
 	// Check we are listening for websocket events for this account
-	{ check(keyDelegateMap.find(account) != keyDelegateMap.cend() || watchers.Find(account.c_str())); }
-	// Also check that we aren't specifically listening for this send block already
-	check(blockListener.find(account) == blockListener.cend());
+	check(keyDelegateMap.find(account) || watchers.find(account));
 
-	auto blockHashStdStr = std::string(TCHAR_TO_UTF8(*responseData.hash));
+	auto hash = HexToKey(responseData.hash);
+	// Also check that we aren't specifically listening for this block already
+	check(!blockListener.find(hash));
 
-	// clang-format off
 	// Keep a mapping of automatic listening delegates
-	auto listenDelegate = &(blockListener.emplace(std::piecewise_construct, std::forward_as_tuple(blockHashStdStr), std::forward_as_tuple(responseData, delegate)).first->second);
-	// clang-format on
+	auto listenDelegate = blockListener.emplace(hash, responseData, delegate).first;
 
 	// Set it up to check if the block is confirmed every few seconds in case the websocket connection has missed any
 	GetWorld()->GetTimerManager().SetTimer(
 		listenDelegate->timerHandle,
-		[this, &blockListener, hash = listenDelegate->data.hash]() {
-			auto it = blockListener.find(std::string(TCHAR_TO_UTF8(*hash)));
-			if (it != blockListener.cend()) {
+		[this, &blockListener, hash]() {
+			auto listenDelegate = blockListener.find(hash);
+			if (listenDelegate) {
 				// Get block_info, if confirmed call delegate, remove timer
-				BlockConfirmed(it->second.data.hash, [this, &blockListener, hash = it->second.data.hash](
-																							 FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful) {
-					auto blockConfirmedData = GetBlockConfirmedResponseData(request, response, wasSuccessful);
-					if (blockConfirmedData.confirmed) {
-						auto it = blockListener.find(std::string(TCHAR_TO_UTF8(*hash)));
-						if (it != blockListener.cend()) {
-							auto delegate = it->second.delegate;
-							GetWorld()->GetTimerManager().ClearTimer(it->second.timerHandle);
-							delegate.ExecuteIfBound(it->second.data);
-							blockListener.erase(it);
+				BlockConfirmed(listenDelegate->data.hash,
+					[this, &blockListener, hash](TSharedPtr<FJsonObject> const& response) {
+						auto blockConfirmedData = GetBlockConfirmedResponseData(response);
+						auto listenDelegate = blockListener.find(hash);
+						if (listenDelegate && blockConfirmedData.confirmed) {
+							// Take it out before calling the delegate, which may register other listeners
+							auto confirmed = MoveTemp(*listenDelegate);
+							blockListener.erase(hash);
+							GetWorld()->GetTimerManager().ClearTimer(confirmed.timerHandle);
+							confirmed.delegate.ExecuteIfBound(confirmed.data);
+						} else if (listenDelegate && !blockConfirmedData.error && dynamicWorkDifficulty && republishTimeout > 0 &&
+											 std::chrono::steady_clock::now() - listenDelegate->published >
+												 std::chrono::duration<float>(republishTimeout)) {
+							listenDelegate->published = std::chrono::steady_clock::now();
+							Republish(response);
 						}
-					}
-				});
+					});
 			}
 		},
 		5.0f, true, 5.0f);
@@ -92,88 +159,358 @@ void UNanoManager::SetupFilteredConfirmationMessageWebsocketListener(UNanoWebsoc
 	}
 }
 
-void UNanoManager::GetWalletBalance(
-	FString address, TFunction<void(FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful)> const& delegate) {
-	FGetBalanceRequestData getBalanceRequestData;
-	getBalanceRequestData.account = address;
-
-	TSharedPtr<FJsonObject> JsonObject = FJsonObjectConverter::UStructToJsonObject(getBalanceRequestData);
-	MakeRequest(JsonObject, delegate);
+void UNanoManager::GetWalletBalance(FString address, TFunction<void(TSharedPtr<FJsonObject> const& response)> const& delegate) {
+	BatchedRequest request;
+	request.text = address;
+	request.delegate = delegate;
+	QueueRequest(RpcBatchKind::balance, MoveTemp(request));
 }
 
 void UNanoManager::GetWalletBalance(FGetBalanceResponseReceivedDelegate delegate, FString address) {
-	GetWalletBalance(address, [this, delegate](FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful) {
-		delegate.ExecuteIfBound(GetBalanceResponseData(request, response, wasSuccessful));
+	GetWalletBalance(address, [delegate, address](TSharedPtr<FJsonObject> const& response) {
+		delegate.ExecuteIfBound(GetBalanceResponseData(response, address));
 	});
 }
 
-TSharedPtr<FJsonObject> UNanoManager::GetWorkGenerateJsonObject(FString hash) {
-	FWorkGenerateRequestData workGenerateRequestData;
-	workGenerateRequestData.hash = hash;
-	return FJsonObjectConverter::UStructToJsonObject(workGenerateRequestData);
+void UNanoManager::WorkGenerate(FWorkGenerateResponseReceivedDelegate delegate, FString hash, FSubtype subtype) {
+	WorkGenerate(hash, WorkThreshold(subtype), [delegate](FWorkGenerateResponseData const& data) { delegate.ExecuteIfBound(data); });
 }
 
-void UNanoManager::WorkGenerate(FWorkGenerateResponseReceivedDelegate delegate, FString hash) {
-	WorkGenerate(hash, [delegate](FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful) {
-		delegate.ExecuteIfBound(GetWorkGenerateResponseData(request, response, wasSuccessful));
+void UNanoManager::WorkGenerate(
+	FString hash, uint64_t threshold, TFunction<void(FWorkGenerateResponseData const&)> const& delegate) {
+	FWorkGenerateResponseData data;
+	data.hash = hash;
+
+	FTCHARToUTF8 utf8(*hash);
+	nano::block_hash root;
+	if (root.decode_hex(utf8.Get(), utf8.Length())) {
+		data.error = true;
+		delegate(data);
+		return;
+	}
+
+	if (!localWork) {
+		auto writer = RequestWriter();
+		nano::rpc::work_generate(writer, root, threshold);
+		MakeRequest(requestContent,
+			[delegate, hash, root, threshold](TSharedPtr<FJsonObject> const& response) {
+				auto data = GetWorkGenerateResponseData(response, hash);
+				SetWorkDifficulty(data, root, threshold);
+				delegate(data);
+			});
+		return;
+	}
+
+	// The pool calls back on one of its own threads, so hand the result back to the game thread
+	TWeakObjectPtr<UNanoManager> weakThis(this);
+	GetWorkPool().generate(root, threshold, [weakThis, delegate, data, root, threshold](bool cancelled, uint64_t work) mutable {
+		data.error = cancelled;
+		if (!cancelled) {
+			std::array<char, 16> text;
+			nano::encode_work(work, text);
+			data.work = FString(static_cast<int32>(text.size()), text.data());
+			SetWorkDifficulty(data, root, threshold);
+		}
+		AsyncTask(ENamedThreads::GameThread, [weakThis, delegate, data]() {
+			if (weakThis.IsValid()) {
+				delegate(data);
+			}
+		});
 	});
 }
 
-void UNanoManager::WorkGenerate(
-	FString hash, TFunction<void(FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful)> const& d) {
-	MakeRequest(GetWorkGenerateJsonObject(hash), d);
+uint64_t UNanoManager::WorkThreshold(FSubtype subtype) {
+	if (!dynamicWorkDifficulty) {
+		return BaseWorkThreshold(subtype);
+	}
+
+	auto& timerManager = GetWorld()->GetTimerManager();
+	if (!timerManager.IsTimerActive(activeDifficultyTimerHandle)) {
+		SampleActiveDifficulty();
+		timerManager.SetTimer(
+			activeDifficultyTimerHandle, [this]() { SampleActiveDifficulty(); }, FMath::Max(activeDifficultyInterval, 1.0f), true);
+	}
+
+	auto multiplier = FMath::Clamp(activeMultiplier, 1.0f, FMath::Max(maxWorkMultiplier, 1.0f));
+	return nano::work_difficulty(multiplier, BaseWorkThreshold(subtype));
 }
 
-TSharedPtr<FJsonObject> UNanoManager::GetPendingJsonObject(FString account, FString threshold, int32 maxCount) {
-	FPendingRequestData pendingRequestData;
-	pendingRequestData.account = account;
-	pendingRequestData.count = FString::FromInt(maxCount);
-	pendingRequestData.threshold = threshold;
-	return FJsonObjectConverter::UStructToJsonObject(pendingRequestData);
+void UNanoManager::SampleActiveDifficulty() {
+	FActiveDifficultyRequestData activeDifficultyRequestData;
+	MakeRequest(FJsonObjectConverter::UStructToJsonObject(activeDifficultyRequestData),
+		[this](TSharedPtr<FJsonObject> const& response) {
+			auto data = GetActiveDifficultyResponseData(response);
+			if (!data.error) {
+				activeMultiplier = data.multiplier;
+			} else {
+				UE_LOG(LogTemp, Warning, TEXT("active_difficulty failed, keeping work multiplier: %f"), activeMultiplier);
+			}
+		});
 }
 
-void UNanoManager::Pending(FPendingResponseReceivedDelegate delegate, FString account, FString threshold, int32 maxCount) {
-	Pending(account, threshold, maxCount, [delegate](FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful) {
-		delegate.ExecuteIfBound(GetPendingResponseData(request, response, wasSuccessful));
+void UNanoManager::Republish(TSharedPtr<FJsonObject> const& response) {
+	TSharedPtr<FJsonObject> const* contents;
+	if (!response || !response->TryGetObjectField("contents", contents)) {
+		return;
+	}
+
+	// The signature doesn't cover the work, so the block keeps its hash and can be republished without the private key
+	FProcessRequestData processRequestData;
+	FJsonObjectConverter::JsonObjectToUStruct((*contents).ToSharedRef(), &processRequestData.block);
+
+	auto subtypeText = response->GetStringField("subtype");
+	auto subtype = (subtypeText == "receive" || subtypeText == "open") ? FSubtype::receive : FSubtype::send;
+	auto previous = HexToKey(processRequestData.block.previous);
+	nano::account account;
+	FTCHARToUTF8 workText(*processRequestData.block.work);
+	uint64_t work = 0;
+	if (DecodeAccount(processRequestData.block.account, account) ||
+			nano::decode_work(workText.Get(), workText.Length(), work)) {
+		return;
+	}
+
+	// Double the work each time up to the limit, after that it is only resent in case the network dropped it
+	auto const& root = previous.is_zero() ? account : previous;
+	auto base = BaseWorkThreshold(subtype);
+	auto current = nano::work_multiplier(nano::work_value(root, work), base);
+	auto multiplier = FMath::Min(FMath::Max(current * 2, nano::work_multiplier(WorkThreshold(subtype), base)),
+		static_cast<double>(FMath::Max(maxWorkMultiplier, 1.0f)));
+	if (multiplier <= current) {
+		MakeRequest(FJsonObjectConverter::UStructToJsonObject(processRequestData), [](TSharedPtr<FJsonObject> const&) {});
+		return;
+	}
+
+	std::array<char, 64> rootText;
+	root.encode_hex(rootText);
+	WorkGenerate(FString(static_cast<int32>(rootText.size()), rootText.data()), nano::work_difficulty(multiplier, base),
+		[this, processRequestData](FWorkGenerateResponseData const& data) mutable {
+			if (!data.error) {
+				processRequestData.block.work = data.work;
+				MakeRequest(
+					FJsonObjectConverter::UStructToJsonObject(processRequestData), [](TSharedPtr<FJsonObject> const&) {});
+			}
+		});
+}
+
+void UNanoManager::CancelWorkGenerate(FString hash) {
+	FTCHARToUTF8 utf8(*hash);
+	nano::block_hash root;
+	if (workPool && !root.decode_hex(utf8.Get(), utf8.Length())) {
+		workPool->cancel(root);
+	}
+}
+
+int64 UNanoManager::GetLocalWorkAttempts() const {
+	return workPool ? static_cast<int64>(workPool->attempts()) : 0;
+}
+
+nano::work_pool& UNanoManager::GetWorkPool() {
+	if (!workPool) {
+		workPool = MakeUnique<nano::work_pool>(static_cast<unsigned>(FMath::Max(localWorkThreads, 0)));
+	}
+	return *workPool;
+}
+
+void UNanoManager::PrecacheWork(nano::account const& account, FString const& root) {
+	FTCHARToUTF8 utf8(*root);
+	nano::block_hash rootHash;
+	if (!precacheWork || rootHash.decode_hex(utf8.Get(), utf8.Length())) {
+		return;
+	}
+
+	auto inserted = precachedWork.emplace(account);
+	auto slot = inserted.first;
+	if (slot->root == rootHash) {
+		// Already cached or being generated
+		return;
+	}
+
+	if (!inserted.second) {
+		// The frontier has moved so the old work can never be used
+		ForgetWork(slot->root);
+	}
+
+	slot->root = rootHash;
+	slot->work = 0;
+	slot->ready = false;
+
+	auto cached = persistWorkCache ? GetWorkCache().find(rootHash) : nullptr;
+	if (cached) {
+		slot->work = cached->work;
+		slot->ready = true;
+		return;
+	}
+
+	// The next block could be anything, send work is enough for all of them
+	WorkGenerate(root, WorkThreshold(FSubtype::send), [this, account, rootHash](FWorkGenerateResponseData const& data) {
+		// The frontier may have moved on while this was generated
+		auto slot = precachedWork.find(account);
+		if (slot && slot->root == rootHash) {
+			FTCHARToUTF8 work(*data.work);
+			if (!data.error && !nano::decode_work(work.Get(), work.Length(), slot->work)) {
+				slot->ready = true;
+				RememberWork(rootHash, slot->work);
+			} else {
+				precachedWork.erase(account);
+			}
+		}
 	});
 }
 
-void UNanoManager::Pending(FString account, FString threshold, int32 maxCount,
-	TFunction<void(FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful)> const& d) {
-	MakeRequest(GetPendingJsonObject(account, threshold, maxCount), d);
+void UNanoManager::CachedWorkGenerate(nano::account const& account, FString const& root, FSubtype subtype,
+	TFunction<void(FWorkGenerateResponseData const&)> const& delegate) {
+	FTCHARToUTF8 utf8(*root);
+	nano::block_hash rootHash;
+	uint64_t work = 0;
+	auto hit = false;
+	if (!rootHash.decode_hex(utf8.Get(), utf8.Length())) {
+		auto slot = precachedWork.find(account);
+		if (slot && slot->ready && slot->root == rootHash) {
+			work = slot->work;
+			hit = true;
+		} else if (precacheWork && persistWorkCache) {
+			// Work saved by a previous run
+			auto cached = GetWorkCache().find(rootHash);
+			if (cached) {
+				work = cached->work;
+				hit = true;
+			}
+		}
+		hit = hit && !nano::work_validate(rootHash, work, WorkThreshold(subtype));
+	}
+
+	if (hit) {
+		FWorkGenerateResponseData data;
+		data.hash = root;
+		std::array<char, 16> text;
+		nano::encode_work(work, text);
+		data.work = FString(static_cast<int32>(text.size()), text.data());
+		SetWorkDifficulty(data, rootHash, WorkThreshold(subtype));
+
+		// Work can only be used for one block
+		auto slot = precachedWork.find(account);
+		if (slot && slot->root == rootHash) {
+			precachedWork.erase(account);
+		}
+		ForgetWork(rootHash);
+		++workCacheHits;
+		delegate(data);
+		return;
+	}
+
+	if (precacheWork) {
+		++workCacheMisses;
+	}
+	WorkGenerate(root, WorkThreshold(subtype), delegate);
+}
+
+FString UNanoManager::GetWorkCachePath() const {
+	return FPaths::Combine(dataPath, WorkCacheFileName);
+}
+
+nano::work_cache& UNanoManager::GetWorkCache() {
+	if (!workCacheLoaded) {
+		workCacheLoaded = true;
+
+		TArray<uint8> contents;
+		FFileHelper::LoadFileToArray(contents, *GetWorkCachePath(), FILEREAD_Silent);
+		auto valid = workCache.load(contents.GetData(), contents.Num());
+		if (valid != static_cast<size_t>(contents.Num()) || contents.Num() == 0 || workCache.needs_compaction()) {
+			// New, torn by a crash or mostly stale
+			RewriteWorkCache();
+		} else {
+			workCacheFile.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*GetWorkCachePath(), true));
+		}
+	}
+	return workCache;
+}
+
+void UNanoManager::RewriteWorkCache() {
+	workCacheFile.Reset();
+
+	auto& platformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if (platformFile.CreateDirectoryTree(*dataPath)) {
+		// Written to the side and moved over, so a crash leaves either the old file or the new one
+		auto contents = workCache.compact();
+		auto temporaryPath = GetWorkCachePath() + TEXT(".tmp");
+		if (FFileHelper::SaveArrayToFile(TArrayView<const uint8>(contents.data(), static_cast<int32>(contents.size())), *temporaryPath) &&
+				IFileManager::Get().Move(*GetWorkCachePath(), *temporaryPath, true)) {
+			workCacheFile.Reset(platformFile.OpenWrite(*GetWorkCachePath(), true));
+		}
+	}
+}
+
+void UNanoManager::AppendWorkCache(nano::work_cache::record const& record) {
+	if (workCacheFile) {
+		workCacheFile->Write(record.data(), record.size());
+		workCacheFile->Flush();
+	}
+
+	if (workCache.needs_compaction()) {
+		RewriteWorkCache();
+	}
+}
+
+void UNanoManager::RememberWork(nano::block_hash const& root, uint64_t work) {
+	if (precacheWork && persistWorkCache) {
+		nano::work_cache::record record;
+		GetWorkCache().insert(root, work, nano::work_value(root, work), record);
+		AppendWorkCache(record);
+	}
+}
+
+void UNanoManager::ForgetWork(nano::block_hash const& root) {
+	nano::work_cache::record record;
+	// The file is only created once there is precached work to keep
+	if (precacheWork && persistWorkCache && GetWorkCache().erase(root, record)) {
+		AppendWorkCache(record);
+	}
 }
 
-TSharedPtr<FJsonObject> UNanoManager::GetAccountFrontierJsonObject(FString const& account) {
-	FAccountFrontierRequestData accountFrontierRequestData;
-	accountFrontierRequestData.account = account;
-	return FJsonObjectConverter::UStructToJsonObject(accountFrontierRequestData);
+void UNanoManager::Pending(FPendingResponseReceivedDelegate delegate, FString account, FString threshold, int32 maxCount) {
+	Pending(account, threshold, maxCount, [this, delegate, account](TArray<uint8> const& response) {
+		delegate.ExecuteIfBound(GetPendingResponseData(response, account));
+	});
 }
 
-TSharedPtr<FJsonObject> UNanoManager::GetBlockConfirmedJsonObject(FString const& hash) {
-	FBlockConfirmedRequestData blockConfirmedRequestData;
-	blockConfirmedRequestData.hash = hash;
-	return FJsonObjectConverter::UStructToJsonObject(blockConfirmedRequestData);
+void UNanoManager::Pending(
+	FString account, FString threshold, int32 maxCount, TFunction<void(TArray<uint8> const& response)> const& d) {
+	BatchedRequest request;
+	request.text = account;
+	request.rawDelegate = d;
+	request.count = FMath::Max(maxCount, 0);
+	request.threshold = threshold;
+	QueueRequest(RpcBatchKind::pending, MoveTemp(request));
 }
 
 void UNanoManager::AccountFrontier(FAccountFrontierResponseReceivedDelegate delegate, FString account) {
-	AccountFrontier(account, [this, delegate](FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful) {
-		delegate.ExecuteIfBound(GetAccountFrontierResponseData(request, response, wasSuccessful));
+	AccountFrontier(account, [this, delegate, account](TSharedPtr<FJsonObject> const& response) {
+		delegate.ExecuteIfBound(GetAccountFrontierResponseData(response, account));
 	});
 }
 
-void UNanoManager::AccountFrontier(
-	FString account, TFunction<void(FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful)> const& delegate) {
-	MakeRequest(GetAccountFrontierJsonObject(account), delegate);
+void UNanoManager::AccountFrontier(FString account, TFunction<void(TSharedPtr<FJsonObject> const& response)> const& delegate) {
+	BatchedRequest request;
+	request.text = account;
+	request.delegate = delegate;
+	QueueRequest(RpcBatchKind::frontier, MoveTemp(request));
 }
 
 void UNanoManager::Process(FProcessResponseReceivedDelegate delegate, FBlock block) {
-	Process(block, [delegate](FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful) {
-		delegate.ExecuteIfBound(GetProcessResponseData(request, response, wasSuccessful));
+	Process(block, [delegate](TSharedPtr<FJsonObject> const& response) {
+		delegate.ExecuteIfBound(GetProcessResponseData(response));
 	});
 }
 
+void UNanoManager::Process(FBlock block, TFunction<void(TSharedPtr<FJsonObject> const& response)> const& delegate) {
+	nano::keyring::entry key;
+	key.prv.data = nano::uint256_union(TCHAR_TO_UTF8(*block.privateKey));
+	key.pub = nano::pub_key(key.prv.data);
+	Process(block, key, delegate);
+}
+
 void UNanoManager::Process(
-	FBlock block, TFunction<void(FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful)> const& delegate) {
+	FBlock const& block, nano::keyring::entry const& key, TFunction<void(TSharedPtr<FJsonObject> const& response)> const& delegate) {
 	nano::account account;
 	account.decode_account(TCHAR_TO_UTF8(*block.account));
 
@@ -185,39 +522,36 @@ void UNanoManager::Process(
 
 	nano::account link(TCHAR_TO_UTF8(*block.link));
 
-	nano::raw_key rawKey;
-	rawKey.data = nano::uint256_union(TCHAR_TO_UTF8(*block.privateKey));
-
 	nano::block_hash previous(TCHAR_TO_UTF8(*block.previous));
 
-	auto publicKey = nano::pub_key(rawKey.data);
-
-	nano::state_block stateBlock(account, previous, representative, balance, link, rawKey, publicKey);
-
-	FProcessRequestData processRequestData;
-	FBlockRequestData blockProcessRequestData;
-	blockProcessRequestData.account = block.account;
-	blockProcessRequestData.balance = block.balance;
-	blockProcessRequestData.previous = block.previous;
-	blockProcessRequestData.representative = block.representative;
-	blockProcessRequestData.link = link.to_string().c_str();
-	blockProcessRequestData.signature = stateBlock.block_signature().to_string().c_str();
-	blockProcessRequestData.work = block.work;
+	// Checked here so a block the node would reject doesn't cost a round trip. Without knowing the subtype and epoch only the
+	// lowest threshold, for receives, can be assumed
+	auto const& root = previous.is_zero() ? account : previous;
+	FTCHARToUTF8 workText(*block.work);
+	uint64_t work;
+	if (nano::decode_work(workText.Get(), workText.Length(), work) || nano::work_validate(root, work, nano::work_thresholds::epoch_2_receive)) {
+		UE_LOG(LogTemp, Warning, TEXT("Not processing block with insufficient work: %s"), *block.work);
+		delegate(nullptr);
+		return;
+	}
 
-	processRequestData.block = blockProcessRequestData;
+	nano::state_block stateBlock(account, previous, representative, balance, link, key.prv, key.pub);
 
-	TSharedPtr<FJsonObject> JsonObject = FJsonObjectConverter::UStructToJsonObject(processRequestData);
-	MakeRequest(JsonObject, delegate);
+	auto writer = RequestWriter();
+	nano::rpc::process(writer, stateBlock.hashables, stateBlock.block_signature(), work);
+	SendRequest(requestContent, delegate);
 }
 
 // This will only call the delegate after the process has been confirmed by the network. Requires a websocket connection
 void UNanoManager::ProcessSendWaitConfirmation(FProcessResponseReceivedDelegate delegate, FBlock block) {
 	// Register a block hash listener which will fire the delegate and remove it
-	Process(block, [this, block, delegate](FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful) {
-		auto processResponseData = GetProcessResponseData(request, response, wasSuccessful);
+	nano::account account;
+	DecodeAccount(block.account, account);
+	Process(block, [this, account, delegate](TSharedPtr<FJsonObject> const& response) {
+		auto processResponseData = GetProcessResponseData(response);
 		if (!processResponseData.error) {
 			RegisterBlockListener<FProcessResponseData, FProcessResponseReceivedDelegate>(
-				TCHAR_TO_UTF8(*block.account), processResponseData, sendBlockListener, delegate);
+				account, processResponseData, sendBlockListener, delegate);
 		} else {
 			delegate.ExecuteIfBound(processResponseData);
 		}
@@ -231,34 +565,35 @@ void UNanoManager::RequestNano(FReceivedNanoDelegate delegate, FString account)
 	requestNanoData.account = account;
 
 	TSharedPtr<FJsonObject> JsonObject = FJsonObjectConverter::UStructToJsonObject(requestNanoData);
-	MakeRequest(JsonObject, [this, delegate](FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful) {
-		delegate.ExecuteIfBound(GetRequestNanoData(request, response, wasSuccessful));
+	MakeRequest(JsonObject, [delegate, account](TSharedPtr<FJsonObject> const& response) {
+		delegate.ExecuteIfBound(GetRequestNanoData(response, account));
 	});
 }
 
 int32 UNanoManager::Watch(const FWatchAccountReceivedDelegate& delegate, FString const& account, UNanoWebsocket* websocket) {
+	nano::account key;
+	if (DecodeAccount(account, key)) {
+		UE_LOG(LogTemp, Warning, TEXT("Cannot watch invalid account: %s"), *account);
+		return -1;
+	}
+
 	websocket->RegisterAccount(account);
 
 	// Keep a mapping of automatic listening delegates
-	auto val = watchers.Find(account);
-	if (val) {
-		val->Add(watcherId, delegate);
-	} else {
-		watchers.Emplace(account, TMap<int32, FWatchAccountReceivedDelegate>{{watcherId, delegate}});
-	}
-
+	watchers.emplace(key).first->Add(watcherId, delegate);
 	return watcherId++;
 }
 
 void UNanoManager::Unwatch(const FString& account, const int32& id, UNanoWebsocket* websocket) {
 	// Check this id exists before unwatching
-	auto map = watchers.Find(account);
+	nano::account key;
+	auto map = !DecodeAccount(account, key) ? watchers.find(key) : nullptr;
 	if (map) {
 		auto delegate = map->Find(id);
 		if (delegate) {
 			map->Remove(id);
 			if (map->Num() == 0) {
-				watchers.Remove(account);
+				watchers.erase(key);
 			}
 			websocket->UnregisterAccount(account);
 		}
@@ -268,169 +603,170 @@ void UNanoManager::Unwatch(const FString& account, const int32& id, UNanoWebsock
 void UNanoManager::AutomaticallyPocketRegister(
 	FAutomateResponseReceivedDelegate delegate, UNanoWebsocket* websocket, FString const& privateKey, FString minimum) {
 	check(!privateKey.IsEmpty());
-	nano::raw_key prvKey;
-	prvKey.data = nano::uint256_union(TCHAR_TO_UTF8(*privateKey));
+	AutomaticallyPocketRegister(delegate, websocket, AcquireKey(privateKey), minimum);
+}
+
+void UNanoManager::AutomaticallyPocketRegisterWithKey(
+	FAutomateResponseReceivedDelegate delegate, UNanoWebsocket* websocket, FNanoKey key, FString minimum) {
+	AutomaticallyPocketRegister(delegate, websocket, AcquireKey(key), minimum);
+}
 
-	auto pubKey = nano::pub_key(prvKey.data);
+void UNanoManager::AutomaticallyPocketRegister(
+	FAutomateResponseReceivedDelegate delegate, UNanoWebsocket* websocket, nano::keyring::handle key, FString const& minimum) {
+	auto entry = keys.find(key);
+	if (!entry) {
+		UE_LOG(LogTemp, Warning, TEXT("Not automatically pocketing for an invalid private key"));
+		fireAutomateDelegateError(delegate);
+		return;
+	}
+	auto pubKey = entry->pub;
 
 	// Check you haven't already added it
-	check(keyDelegateMap.find(pubKey.to_account()) == keyDelegateMap.cend());
+	check(!keyDelegateMap.find(pubKey));
 
-	websocket->RegisterAccount(pubKey.to_account().c_str());
+	websocket->RegisterAccount(KeyAccount(*entry));
 
 	// Keep a mapping of automatic listening delegates
-	// clang-format off
-	auto prvKeyAutomateDelegate = &(keyDelegateMap.emplace(std::piecewise_construct, std::forward_as_tuple(pubKey.to_account()),
-															std::forward_as_tuple(privateKey, delegate, minimum)).first->second);
-	// clang-format on
+	auto prvKeyAutomateDelegate = keyDelegateMap.emplace(pubKey, key, delegate, minimum).first;
 
 	// Set it up to check for pending blocks every few seconds in case the websocket connection has missed any
 	GetWorld()->GetTimerManager().SetTimer(
 		prvKeyAutomateDelegate->timerHandle,
 		[this, pubKey, minimum]() {
-			auto it = keyDelegateMap.find(pubKey.to_account());
-			if (it != keyDelegateMap.end()) {
-				AutomatePocketPendingUtility(pubKey.to_account().c_str(), minimum);
+			if (keyDelegateMap.find(pubKey)) {
+				AutomatePocketPendingUtility(pubKey, minimum);
 			}
 		},
 		5.0f, true, 1.f);
 }
 
 void UNanoManager::AutomaticallyPocketUnregister(const FString& account, UNanoWebsocket* websocket) {
-	// Remove timer (has to be the exact one, doesn't work if it's been copied.
-	auto it = keyDelegateMap.find(TCHAR_TO_UTF8(*account));
-	if (it != keyDelegateMap.cend()) {
-		if (!it->second.prvKey.IsEmpty()) {
-			GetWorld()->GetTimerManager().ClearTimer(it->second.timerHandle);
+	nano::account key;
+	auto prvKeyAutomateDelegate = !DecodeAccount(account, key) ? keyDelegateMap.find(key) : nullptr;
+	if (prvKeyAutomateDelegate) {
+		if (prvKeyAutomateDelegate->key != nano::keyring::invalid) {
+			GetWorld()->GetTimerManager().ClearTimer(prvKeyAutomateDelegate->timerHandle);
+			keys.erase(prvKeyAutomateDelegate->key);
 		}
-		keyDelegateMap.erase(it);
+		keyDelegateMap.erase(key);
 		websocket->UnregisterAccount(account);
 	}
 }
 
-void UNanoManager::AutomatePocketPendingUtility(const FString& account, const FString& minimum) {
-	AccountFrontier(account, [this, account, minimum](FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful) {
-		auto frontierData = GetAccountFrontierResponseData(request, response, wasSuccessful);
-		if (!frontierData.error) {
-			const auto numPending = 5;
-			Pending(
-				account, minimum, numPending, [this, frontierData](FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful) {
-					auto pendingData = GetPendingResponseData(request, response, wasSuccessful);
-					if (!pendingData.error) {
-						if (pendingData.blocks.Num() > 0) {
-							AutomateWorkGenerateLoop(frontierData, pendingData.blocks);
-						}
-					} else {
-						auto it = keyDelegateMap.find(TCHAR_TO_UTF8(*frontierData.account));
-						if (it != keyDelegateMap.end()) {
-							fireAutomateDelegateError(it->second.delegate);
+void UNanoManager::AutomatePocketPendingUtility(nano::account const& account, const FString& minimum) {
+	auto encodedAccount = EncodeAccount(account);
+	AccountFrontier(
+		encodedAccount, [this, account, encodedAccount, minimum](TSharedPtr<FJsonObject> const& response) {
+			auto frontierData = GetAccountFrontierResponseData(response, encodedAccount);
+			if (!frontierData.error) {
+				const auto numPending = 5;
+				Pending(frontierData.account, minimum, numPending,
+					[this, account, frontierData](TArray<uint8> const& response) {
+						auto pendingData = GetPendingResponseData(response, frontierData.account);
+						if (!pendingData.error) {
+							if (pendingData.blocks.Num() > 0) {
+								AutomateWorkGenerateLoop(frontierData, pendingData.blocks);
+							}
+						} else {
+							auto prvKeyAutomateDelegate = keyDelegateMap.find(account);
+							if (prvKeyAutomateDelegate) {
+								fireAutomateDelegateError(prvKeyAutomateDelegate->delegate);
+							}
 						}
-					}
-				});
-		} else {
-			auto it = keyDelegateMap.find(TCHAR_TO_UTF8(*account));
-			if (it != keyDelegateMap.end()) {
-				fireAutomateDelegateError(it->second.delegate);
+					});
+			} else {
+				auto prvKeyAutomateDelegate = keyDelegateMap.find(account);
+				if (prvKeyAutomateDelegate) {
+					fireAutomateDelegateError(prvKeyAutomateDelegate->delegate);
+				}
 			}
-		}
-	});
+		});
 }
 
 void UNanoManager::AutomateWorkGenerateLoop(FAccountFrontierResponseData frontierData, TArray<FPendingBlock> pendingBlocks) {
-	WorkGenerate(frontierData.hash,
-		[this, frontierData, pendingBlocks](FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful) mutable {
-			auto workData = GetWorkGenerateResponseData(request, response, wasSuccessful);
-
-			if (!workData.error && pendingBlocks.Num() != 0) {
-				// Create the receive block
-				nano::account account;
-				account.decode_account(TCHAR_TO_UTF8(*frontierData.account));
-
-				// Use the first block
-				auto pendingBlock = pendingBlocks[0];
-				pendingBlocks.RemoveAt(0);	// Pop from front
-
-				nano::amount amount;
-				amount.decode_dec(TCHAR_TO_UTF8(*pendingBlock.amount));
-
-				nano::amount balance;
-				balance.decode_dec(TCHAR_TO_UTF8(*frontierData.balance));
-
-				auto newBalance = balance.number() + amount.number();
-
-				FBlock block;
-				block.account = account.to_account().c_str();
-				auto str = newBalance.ToString();
-				str.RemoveFromStart(TEXT("0x"));
-				block.balance = FString(BaseConverter::HexToDecimalConverter().Convert(std::string(TCHAR_TO_UTF8(*str.ToUpper()))).c_str());
-				block.link = pendingBlock.hash;	 // source hash
-
-				// Need to check if this is the open block
-				if (account == nano::account(TCHAR_TO_UTF8(*frontierData.hash))) {
-					block.previous = "0";
-				} else {
-					block.previous = frontierData.hash;
-				}
-
-				auto it = keyDelegateMap.find(TCHAR_TO_UTF8(*frontierData.account));
-				if (it != keyDelegateMap.end()) {
-					block.privateKey = it->second.prvKey;
-					block.representative = TCHAR_TO_UTF8(*frontierData.representative);
-					block.work = workData.work;
+	nano::account account;
+	DecodeAccount(frontierData.account, account);
+	CachedWorkGenerate(account, frontierData.hash, FSubtype::receive, [this, account, frontierData, pendingBlocks](
+																								 FWorkGenerateResponseData const& workData) mutable {
+		if (!workData.error && pendingBlocks.Num() != 0) {
+			// Create the receive block
+
+			// Use the first block
+			auto pendingBlock = pendingBlocks[0];
+			pendingBlocks.RemoveAt(0);	// Pop from front
+
+			auto newBalance = frontierData.balanceValue + pendingBlock.amountValue;
+
+			FBlock block;
+			block.account = EncodeAccount(account);
+			block.balance = newBalance.ToRaw();
+			block.link = pendingBlock.hash;	 // source hash
+
+			// Need to check if this is the open block
+			if (account == nano::account(TCHAR_TO_UTF8(*frontierData.hash))) {
+				block.previous = "0";
+			} else {
+				block.previous = frontierData.hash;
+			}
 
-					// Form the output data
-					FAutomateResponseData automateData;
-					automateData.type = FConfType::receive;
-
-					str = amount.number().ToString();
-					str.RemoveFromStart(TEXT("0x"));
-					automateData.amount =
-						FString(BaseConverter::HexToDecimalConverter().Convert(std::string(TCHAR_TO_UTF8(*str.ToUpper()))).c_str());
-					automateData.balance = block.balance;
-					automateData.account = block.account;
-					automateData.representative = block.representative;
-
-					Process(block,
-						[this, pendingBlocks, automateData](FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful) mutable {
-							auto processData = GetProcessResponseData(request, response, wasSuccessful);
-							if (!processData.error) {
-								automateData.frontier = processData.hash;
-								automateData.hash = processData.hash;
-
-								auto it = keyDelegateMap.find(TCHAR_TO_UTF8(*automateData.account));
-								if (it != keyDelegateMap.end()) {
-									// Fire it back to the user
-									FAutomateResponseReceivedDelegate delegate = it->second.delegate;
-									RegisterBlockListener<FAutomateResponseData, FAutomateResponseReceivedDelegate>(
-										TCHAR_TO_UTF8(*automateData.account), automateData, receiveBlockListener, delegate);
-
-									// If there are any more pending, then redo this process
-									if (pendingBlocks.Num() > 0) {
-										FAccountFrontierResponseData accountFrontierData;
-
-										accountFrontierData.account = automateData.account;
-										accountFrontierData.balance = automateData.balance;
-										accountFrontierData.hash = automateData.frontier;
-										accountFrontierData.representative = automateData.representative;
-
-										AutomateWorkGenerateLoop(accountFrontierData, pendingBlocks);
-									}
-								}
-							} else {
-								auto it = keyDelegateMap.find(TCHAR_TO_UTF8(*automateData.account));
-								if (it != keyDelegateMap.end()) {
-									fireAutomateDelegateError(it->second.delegate);
+			auto prvKeyAutomateDelegate = keyDelegateMap.find(account);
+			auto key = prvKeyAutomateDelegate ? keys.find(prvKeyAutomateDelegate->key) : nullptr;
+			if (key) {
+				block.representative = TCHAR_TO_UTF8(*frontierData.representative);
+				block.work = workData.work;
+
+				// Form the output data
+				FAutomateResponseData automateData;
+				automateData.type = FConfType::receive;
+
+				automateData.amount = pendingBlock.amount;
+				automateData.balance = block.balance;
+				automateData.amountValue = pendingBlock.amountValue;
+				automateData.balanceValue = newBalance;
+				automateData.account = block.account;
+				automateData.representative = block.representative;
+
+				Process(block, *key, [this, account, pendingBlocks, automateData](TSharedPtr<FJsonObject> const& response) mutable {
+						auto processData = GetProcessResponseData(response);
+						if (!processData.error) {
+							automateData.frontier = processData.hash;
+							automateData.hash = processData.hash;
+
+							auto prvKeyAutomateDelegate = keyDelegateMap.find(account);
+							if (prvKeyAutomateDelegate) {
+								// Fire it back to the user
+								FAutomateResponseReceivedDelegate delegate = prvKeyAutomateDelegate->delegate;
+								RegisterBlockListener<FAutomateResponseData, FAutomateResponseReceivedDelegate>(
+									account, automateData, receiveBlockListener, delegate);
+
+								// If there are any more pending, then redo this process
+								if (pendingBlocks.Num() > 0) {
+									FAccountFrontierResponseData accountFrontierData;
+
+									accountFrontierData.account = automateData.account;
+									accountFrontierData.balance = automateData.balance;
+									accountFrontierData.balanceValue = automateData.balanceValue;
+									accountFrontierData.hash = automateData.frontier;
+									accountFrontierData.representative = automateData.representative;
+
+									AutomateWorkGenerateLoop(accountFrontierData, pendingBlocks);
 								}
 							}
-						});
-				}
-			} else {
-				auto it = keyDelegateMap.find(TCHAR_TO_UTF8(*frontierData.account));
-				if (it != keyDelegateMap.end()) {
-					fireAutomateDelegateError(it->second.delegate);
-				}
+						} else {
+							auto prvKeyAutomateDelegate = keyDelegateMap.find(account);
+							if (prvKeyAutomateDelegate) {
+								fireAutomateDelegateError(prvKeyAutomateDelegate->delegate);
+							}
+						}
+					});
 			}
-		});
+		} else {
+			auto prvKeyAutomateDelegate = keyDelegateMap.find(account);
+			if (prvKeyAutomateDelegate) {
+				fireAutomateDelegateError(prvKeyAutomateDelegate->delegate);
+			}
+		}
+	});
 }
 
 FAutomateResponseData UNanoManager::GetWebsocketResponseData(const FString& amount, const FString& hash, FString const& account,
@@ -439,19 +775,23 @@ FAutomateResponseData UNanoManager::GetWebsocketResponseData(const FString& amou
 	automateData.type = type;
 	automateData.amount = amount;
 	automateData.balance = frontierData.balance;
+	automateData.amountValue = FNanoAmount::FromRaw(amount);
+	automateData.balanceValue = frontierData.balanceValue;
 	automateData.account = account;
 	automateData.frontier = frontierData.hash;
 	automateData.hash = hash;
 	return automateData;
 }
 
-void UNanoManager::GetFrontierAndFireWatchers(const FString& amount, const FString& hash, FString const& account, FConfType type) {
+void UNanoManager::GetFrontierAndFireWatchers(
+	const FString& amount, const FString& hash, nano::account const& key, FConfType type) {
 	// Get the account info and send that back along with the block that has been sent
-	AccountFrontier(TCHAR_TO_UTF8(*account),
-		[this, account, amount, hash, type](FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful) {
-			auto frontierData = GetAccountFrontierResponseData(request, response, wasSuccessful);
+	auto account = EncodeAccount(key);
+	AccountFrontier(account,
+		[this, key, account, amount, hash, type](TSharedPtr<FJsonObject> const& response) {
+			auto frontierData = GetAccountFrontierResponseData(response, account);
 
-			auto idDelegateMap = watchers.Find(account);
+			auto idDelegateMap = watchers.find(key);
 			if (idDelegateMap) {
 				// Copy delegates in case someone unwatches during this call
 				TArray<FWatchAccountReceivedDelegate> delegates;
@@ -477,22 +817,25 @@ void UNanoManager::GetFrontierAndFireWatchers(const FString& amount, const FStri
 		});
 }
 
-void UNanoManager::GetFrontierAndFire(const FString& amount, const FString& hash, FString const& account, FConfType type) {
+void UNanoManager::GetFrontierAndFire(const FString& amount, const FString& hash, nano::account const& key, FConfType type) {
 	// Get the account info and send that back along with the block that has been sent
-	AccountFrontier(TCHAR_TO_UTF8(*account),
-		[this, account, amount, hash, type](FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful) {
-			auto frontierData = GetAccountFrontierResponseData(request, response, wasSuccessful);
-
-			auto it = keyDelegateMap.find(TCHAR_TO_UTF8(*account));
-			if (it != keyDelegateMap.end()) {
+	auto account = EncodeAccount(key);
+	AccountFrontier(account,
+		[this, key, account, amount, hash, type](TSharedPtr<FJsonObject> const& response) {
+			auto frontierData = GetAccountFrontierResponseData(response, account);
+
+			auto prvKeyAutomateDelegate = keyDelegateMap.find(key);
+			if (prvKeyAutomateDelegate) {
+				// Copy in case the delegate unregisters this account
+				auto delegate = prvKeyAutomateDelegate->delegate;
 				if (!frontierData.error) {
 					// Form the output data
 					auto automateData = GetWebsocketResponseData(amount, hash, account, type, frontierData);
 
 					// Fire it back to the user
-					it->second.delegate.ExecuteIfBound(automateData);
+					delegate.ExecuteIfBound(automateData);
 				} else {
-					fireAutomateDelegateError(it->second.delegate);
+					fireAutomateDelegateError(delegate);
 				}
 			}
 		});
@@ -508,50 +851,52 @@ void UNanoManager::OnConfirmationReceiveMessage(const FWebsocketConfirmationResp
 
 	// We could be monitoring multiple accounts which may be interacting with each other so need to check all
 	if (data.block.subtype == FSubtype::send) {
-		// Check if this is a send to an account we are watching
-		auto linkAsAccount =
-			FString(nano::account(TCHAR_TO_UTF8(*data.block.link)).to_account().c_str());	 // Convert link as hash to account
+		// Check if this is a send to an account we are watching, the link is the destination account as hex
+		auto link = HexToKey(data.block.link);
 
-		auto it = keyDelegateMap.find(TCHAR_TO_UTF8(*linkAsAccount));
-		if (it != keyDelegateMap.end()) {
-			if (UNanoBlueprintLibrary::GreaterOrEqual(data.amount, it->second.minimum)) {
+		auto prvKeyAutomateDelegate = keyDelegateMap.find(link);
+		if (prvKeyAutomateDelegate) {
+			if (data.amountValue >= prvKeyAutomateDelegate->minimumValue) {
 				// Pocket the block, also check if there are more pending
-				AutomatePocketPendingUtility(linkAsAccount, it->second.minimum);
+				AutomatePocketPendingUtility(link, prvKeyAutomateDelegate->minimum);
 			}
 		}
 
-		auto accountWatchers = watchers.Find(linkAsAccount);
-		if (accountWatchers) {
+		if (watchers.find(link)) {
 			// We are just watching this so return the block (after getting account frontier information)
-			GetFrontierAndFireWatchers(data.amount, data.hash, linkAsAccount, FConfType::send_to);
+			GetFrontierAndFireWatchers(data.amount, data.hash, link, FConfType::send_to);
 		}
 
 		// Check if this is a send from an account we are watching
 		auto account = data.block.account;
-		if (keyDelegateMap.count(TCHAR_TO_UTF8(*account)) > 0) {
-			// This is a send from us to someone else
-			GetFrontierAndFire(data.amount, data.hash, account, FConfType::send_from);
-		}
+		nano::account key;
+		if (!DecodeAccount(account, key)) {
+			if (keyDelegateMap.find(key)) {
+				// This is a send from us to someone else
+				PrecacheWork(key, data.hash);
+				GetFrontierAndFire(data.amount, data.hash, key, FConfType::send_from);
+			}
 
-		accountWatchers = watchers.Find(account);
-		if (accountWatchers) {
-			// We are just watching this so return the block (after getting account frontier information)
-			GetFrontierAndFireWatchers(data.amount, data.hash, account, FConfType::send_from);
+			if (watchers.find(key)) {
+				// We are just watching this so return the block (after getting account frontier information)
+				GetFrontierAndFireWatchers(data.amount, data.hash, key, FConfType::send_from);
+			}
 		}
 
 		// If we are listening for confirmations for this send block
-		auto hash_std_str = std::string(TCHAR_TO_UTF8(*data.hash));
-		auto it1 = sendBlockListener.find(hash_std_str);
-		if (it1 != sendBlockListener.cend()) {
-			// Call delegate now that the send has been confirmed
-			GetWorld()->GetTimerManager().ClearTimer(it1->second.timerHandle);
-			it1->second.delegate.ExecuteIfBound(it1->second.data);
-			sendBlockListener.erase(it1);
+		auto hash = HexToKey(data.hash);
+		auto sendListener = sendBlockListener.find(hash);
+		if (sendListener) {
+			// Call delegate now that the send has been confirmed, it may register other listeners so take it out first
+			auto confirmed = MoveTemp(*sendListener);
+			sendBlockListener.erase(hash);
+			GetWorld()->GetTimerManager().ClearTimer(confirmed.timerHandle);
+			confirmed.delegate.ExecuteIfBound(confirmed.data);
 		}
 
 		// Are we listening for a payment? Only one of these will be active at once
 		if (listeningPayment.delegate.IsBound()) {
-			if (listeningPayment.account == linkAsAccount && listeningPayment.amount == data.amount) {
+			if (listeningPayment.account == EncodeAccount(link) && listeningPayment.amountValue == data.amountValue) {
 				Unwatch(listeningPayment.account, listeningPayment.watchId, websocket);
 				GetWorld()->GetTimerManager().ClearTimer(listeningPayment.timerHandle);
 				listeningPayment.delegate.ExecuteIfBound(data.hash, listeningPayment.amount);
@@ -560,7 +905,7 @@ void UNanoManager::OnConfirmationReceiveMessage(const FWebsocketConfirmationResp
 		}
 
 		if (listeningPayout.delegate.IsBound()) {
-			if (listeningPayout.account == account && data.amount == "0") {
+			if (listeningPayout.account == account && data.amountValue.IsZero()) {
 				Unwatch(listeningPayment.account, listeningPayout.watchId, websocket);
 				GetWorld()->GetTimerManager().ClearTimer(listeningPayout.timerHandle);
 				listeningPayout.delegate.ExecuteIfBound(false);
@@ -569,41 +914,45 @@ void UNanoManager::OnConfirmationReceiveMessage(const FWebsocketConfirmationResp
 		}
 
 	} else if (data.block.subtype == FSubtype::receive || data.block.subtype == FSubtype::open) {
-		auto account = data.account;
-		if (keyDelegateMap.count(TCHAR_TO_UTF8(*account)) > 0) {
-			// Received this block from websocket so don't need to have the receive block listener timer listening for it anymore.
-			auto it = receiveBlockListener.find(std::string(TCHAR_TO_UTF8(*data.hash)));
-			if (it != receiveBlockListener.cend()) {
-				GetWorld()->GetTimerManager().ClearTimer(it->second.timerHandle);
-				receiveBlockListener.erase(it);
-			}
+		nano::account account;
+		if (!DecodeAccount(data.account, account)) {
+			if (keyDelegateMap.find(account)) {
+				// Received this block from websocket so don't need to have the receive block listener timer listening for it anymore.
+				auto hash = HexToKey(data.hash);
+				auto receiveListener = receiveBlockListener.find(hash);
+				if (receiveListener) {
+					GetWorld()->GetTimerManager().ClearTimer(receiveListener->timerHandle);
+					receiveBlockListener.erase(hash);
+				}
 
-			GetFrontierAndFire(data.amount, data.hash, account, FConfType::receive);
-		}
+				PrecacheWork(account, data.hash);
+				GetFrontierAndFire(data.amount, data.hash, account, FConfType::receive);
+			}
 
-		auto accountWatchers = watchers.Find(account);
-		if (accountWatchers) {
-			// We are just watching this so return the block (after getting account frontier information)
-			GetFrontierAndFireWatchers(data.amount, data.hash, account, FConfType::receive);
+			if (watchers.find(account)) {
+				// We are just watching this so return the block (after getting account frontier information)
+				GetFrontierAndFireWatchers(data.amount, data.hash, account, FConfType::receive);
+			}
 		}
 	}
 }
 
 void UNanoManager::BlockConfirmed(FBlockConfirmedResponseReceivedDelegate delegate, FString hash) {
-	BlockConfirmed(hash, [this, delegate](FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful) {
-		delegate.ExecuteIfBound(GetBlockConfirmedResponseData(request, response, wasSuccessful));
+	BlockConfirmed(hash, [delegate](TSharedPtr<FJsonObject> const& response) {
+		delegate.ExecuteIfBound(GetBlockConfirmedResponseData(response));
 	});
 }
 
-void UNanoManager::BlockConfirmed(
-	FString hash, TFunction<void(FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful)> const& delegate) {
-	MakeRequest(GetBlockConfirmedJsonObject(hash), delegate);
+void UNanoManager::BlockConfirmed(FString hash, TFunction<void(TSharedPtr<FJsonObject> const& response)> const& delegate) {
+	BatchedRequest request;
+	request.text = hash;
+	request.delegate = delegate;
+	QueueRequest(RpcBatchKind::blockInfo, MoveTemp(request));
 }
 
 void UNanoManager::SendWaitConfirmationBlock(FProcessResponseReceivedDelegate delegate, FBlock block) {
-	Process(block, [this, delegate, account = nano::account(TCHAR_TO_UTF8(*block.link)).to_account()](
-									 FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful) {
-		auto processResponseData = GetProcessResponseData(request, response, wasSuccessful);
+	Process(block, [this, delegate, account = HexToKey(block.link)](TSharedPtr<FJsonObject> const& response) {
+		auto processResponseData = GetProcessResponseData(response);
 		if (!processResponseData.error) {
 			RegisterBlockListener<FProcessResponseData, FProcessResponseReceivedDelegate>(
 				account, processResponseData, sendBlockListener, delegate);
@@ -616,28 +965,44 @@ void UNanoManager::SendWaitConfirmationBlock(FProcessResponseReceivedDelegate de
 // This will only call the delegate after the send has been confirmed by the network. Requires a websocket connection
 void UNanoManager::SendWaitConfirmation(
 	FProcessResponseReceivedDelegate delegate, FString const& privateKey, FString const& account, FString const& amount) {
+	SendWaitConfirmation(AcquireKey(privateKey), account, amount, delegate);
+}
+
+void UNanoManager::SendWaitConfirmationWithKey(
+	FProcessResponseReceivedDelegate delegate, FNanoKey key, FString const& account, FString const& amount) {
+	SendWaitConfirmation(AcquireKey(key), account, amount, delegate);
+}
+
+void UNanoManager::SendWaitConfirmation(
+	nano::keyring::handle key, FString const& account, FString const& amount, FProcessResponseReceivedDelegate delegate) {
 	// Register a block hash listener which will fire the delegate and remove it
-	Send(privateKey, account, amount, [this, privateKey, account, amount, delegate](FProcessResponseData processResponseData) {
-		if (!processResponseData.error) {
+	Send(key, account, amount, [this, key, delegate](FProcessResponseData processResponseData) {
+		auto entry = keys.find(key);
+		if (!processResponseData.error && entry) {
 			// Register a block listener which will call the user delegate when a confirmation response from the network is received
-			nano::raw_key prvKey;
-			prvKey.data = nano::uint256_union(TCHAR_TO_UTF8(*privateKey));
-			auto pubKey = nano::pub_key(prvKey.data);
 			RegisterBlockListener<FProcessResponseData, FProcessResponseReceivedDelegate>(
-				pubKey.to_account(), processResponseData, sendBlockListener, delegate);
+				entry->pub, processResponseData, sendBlockListener, delegate);
 		} else {
 			delegate.ExecuteIfBound(processResponseData);
 		}
+		keys.erase(key);
 	});
 }
 
-void UNanoManager::Send(
-	FString const& privateKey, FString const& account, FString const& amount, TFunction<void(FProcessResponseData)> const& delegate) {
-	MakeSendBlock(privateKey, amount, account, [delegate, this](FMakeBlockResponseData data) {
-		if (!data.error) {
+void UNanoManager::Send(nano::keyring::handle key, FString const& account, FString const& amount,
+	TFunction<void(FProcessResponseData)> const& delegate) {
+	MakeSendBlock(key, amount, account, [delegate, key, this](FMakeBlockResponseData data) {
+		auto entry = keys.find(key);
+		if (!data.error && entry) {
 			// Process the process
-			Process(data.block, [delegate](FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful) {
-				delegate(GetProcessResponseData(request, response, wasSuccessful));
+			Process(data.block, *entry, [this, delegate, data](TSharedPtr<FJsonObject> const& response) {
+				auto processData = GetProcessResponseData(response);
+				nano::account key;
+				if (!processData.error && !DecodeAccount(data.block.account, key)) {
+					// The send is the new frontier, so work for the next block can start now
+					PrecacheWork(key, processData.hash);
+				}
+				delegate(processData);
 			});
 		} else {
 			FProcessResponseData processData;
@@ -651,47 +1016,73 @@ void UNanoManager::Send(
 // security use SendWaitConfirmation.
 void UNanoManager::Send(
 	FProcessResponseReceivedDelegate delegate, FString const& privateKey, FString const& account, FString const& amount) {
-	Send(privateKey, account, amount, [this, delegate](const FProcessResponseData& data) { delegate.ExecuteIfBound(data); });
+	auto key = AcquireKey(privateKey);
+	Send(key, account, amount, [this, key, delegate](const FProcessResponseData& data) {
+		keys.erase(key);
+		delegate.ExecuteIfBound(data);
+	});
+}
+
+void UNanoManager::SendWithKey(
+	FProcessResponseReceivedDelegate delegate, FNanoKey key, FString const& account, FString const& amount) {
+	auto handle = AcquireKey(key);
+	Send(handle, account, amount, [this, handle, delegate](const FProcessResponseData& data) {
+		keys.erase(handle);
+		delegate.ExecuteIfBound(data);
+	});
 }
 
 void UNanoManager::MakeSendBlock(
 	FMakeBlockDelegate delegate, FString const& prvKey, FString const& amount, FString const& destinationAccount) {
-	MakeSendBlock(
-		prvKey, amount, destinationAccount, [this, delegate](const FMakeBlockResponseData& data) { delegate.ExecuteIfBound(data); });
+	auto key = AcquireKey(prvKey);
+	MakeSendBlock(key, amount, destinationAccount, [this, key, delegate](const FMakeBlockResponseData& data) {
+		keys.erase(key);
+		delegate.ExecuteIfBound(data);
+	});
 }
 
-void UNanoManager::MakeSendBlock(FString const& privateKey, FString const& amount, FString const& destinationAccount,
+void UNanoManager::MakeSendBlockWithKey(
+	FMakeBlockDelegate delegate, FNanoKey key, FString const& amount, FString const& destinationAccount) {
+	auto handle = AcquireKey(key);
+	MakeSendBlock(handle, amount, destinationAccount, [this, handle, delegate](const FMakeBlockResponseData& data) {
+		keys.erase(handle);
+		delegate.ExecuteIfBound(data);
+	});
+}
+
+void UNanoManager::MakeSendBlock(nano::keyring::handle key, FString const& amount, FString const& destinationAccount,
 	TFunction<void(FMakeBlockResponseData)> const& delegate) {
 	// Need to construct the block myself
-	nano::raw_key prvKey;
-	prvKey.data = nano::uint256_union(TCHAR_TO_UTF8(*privateKey));
-
-	auto pubKey = nano::pub_key(prvKey.data);
+	auto entry = keys.find(key);
+	if (!entry) {
+		fireMakeBlockDelegateError(delegate);
+		return;
+	}
 
 	nano::account acc;
 	acc.decode_account(TCHAR_TO_UTF8(*destinationAccount));
 
 	FSendArgs sendArgs;
-	sendArgs.privateKey = privateKey;
 	sendArgs.account = acc.to_string().c_str();
 	sendArgs.amount = amount;
 
 	// Get the frontier
-	AccountFrontier(pubKey.to_account().c_str(),
-		[this, sendArgs, delegate](FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful) mutable {
-			auto accountFrontierResponseData = GetAccountFrontierResponseData(request, response, wasSuccessful);
+	auto encodedAccount = KeyAccount(*entry);
+	AccountFrontier(encodedAccount,
+		[this, key, encodedAccount, sendArgs, delegate](TSharedPtr<FJsonObject> const& response) mutable {
+			auto accountFrontierResponseData = GetAccountFrontierResponseData(response, encodedAccount);
 			if (!accountFrontierResponseData.error) {
 				sendArgs.balance = accountFrontierResponseData.balance;
 				sendArgs.frontier = accountFrontierResponseData.hash;
 				sendArgs.representative = accountFrontierResponseData.representative;
 
 				// Generate work
-				WorkGenerate(accountFrontierResponseData.hash,
-					[this, sendArgs, delegate](FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful) {
-						auto workGenerateResponseData = GetWorkGenerateResponseData(request, response, wasSuccessful);
-						if (workGenerateResponseData.hash != "0") {
-							auto prvKey = nano::uint256_union(TCHAR_TO_UTF8(*sendArgs.privateKey));
-							auto thisAccountPublicKey = (nano::pub_key(prvKey));
+				nano::account account;
+				DecodeAccount(accountFrontierResponseData.account, account);
+				CachedWorkGenerate(account, accountFrontierResponseData.hash, FSubtype::send,
+					[this, key, sendArgs, delegate](FWorkGenerateResponseData const& workGenerateResponseData) {
+						auto entry = keys.find(key);
+						if (!workGenerateResponseData.error && entry) {
 							nano::account acc(TCHAR_TO_UTF8(*sendArgs.account));
 
 							nano::amount bal;
@@ -701,74 +1092,97 @@ void UNanoManager::MakeSendBlock(FString const& privateKey, FString const& amoun
 							amo.decode_dec(TCHAR_TO_UTF8(*sendArgs.amount));
 
 							FBlock block;
-							block.account = thisAccountPublicKey.to_account().c_str();
+							block.account = KeyAccount(*entry);
 
-							auto str = (bal.number() - amo.number()).ToString();
-							str.RemoveFromStart(TEXT("0x"));
-							block.balance =
-								FString(BaseConverter::HexToDecimalConverter().Convert(std::string(TCHAR_TO_UTF8(*str.ToUpper()))).c_str());
+							block.balance = nano::amount(bal.number() - amo.number()).to_string_dec().c_str();
 
 							block.link = acc.to_string().c_str();
 							block.previous = sendArgs.frontier;
-							block.privateKey = sendArgs.privateKey;
+							block.privateKey = entry->prv.data.to_string().c_str();
 							block.representative = sendArgs.representative;
 							block.work = workGenerateResponseData.work;
 
 							FMakeBlockResponseData makeBlockData;
 							makeBlockData.block = block;
 							delegate(makeBlockData);
+						} else {
+							fireMakeBlockDelegateError(delegate);
 						}
 					});
 			} else {
-				FMakeBlockResponseData makeBlockData;
-				makeBlockData.error = true;
-				delegate(makeBlockData);
+				fireMakeBlockDelegateError(delegate);
 			}
 		});
 }
 
 void UNanoManager::Receive(
 	const FProcessResponseReceivedDelegate& delegate, FString const& privateKey, FString sourceHash, FString const& amount) {
-	MakeReceiveBlock(privateKey, sourceHash, amount, [delegate, this](FMakeBlockResponseData data) {
-		if (!data.error) {
+	Receive(AcquireKey(privateKey), sourceHash, amount, delegate);
+}
+
+void UNanoManager::ReceiveWithKey(
+	const FProcessResponseReceivedDelegate& delegate, FNanoKey key, FString sourceHash, FString const& amount) {
+	Receive(AcquireKey(key), sourceHash, amount, delegate);
+}
+
+void UNanoManager::Receive(
+	nano::keyring::handle key, FString sourceHash, FString const& amount, FProcessResponseReceivedDelegate delegate) {
+	MakeReceiveBlock(key, sourceHash, amount, [delegate, key, this](FMakeBlockResponseData data) {
+		auto entry = keys.find(key);
+		if (!data.error && entry) {
 			// Process the process
-			Process(data.block, [delegate](FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful) {
-				delegate.ExecuteIfBound(GetProcessResponseData(request, response, wasSuccessful));
+			Process(data.block, *entry, [delegate](TSharedPtr<FJsonObject> const& response) {
+				delegate.ExecuteIfBound(GetProcessResponseData(response));
 			});
 		} else {
 			FProcessResponseData processData;
 			processData.error = true;
 			delegate.ExecuteIfBound(processData);
 		}
+		// Process has signed the block by now
+		keys.erase(key);
 	});
 }
 
 void UNanoManager::MakeReceiveBlock(
 	FMakeBlockDelegate delegate, FString const& privateKey, FString sourceHash, FString const& amount) {
-	MakeReceiveBlock(
-		privateKey, sourceHash, amount, [this, delegate](const FMakeBlockResponseData& data) { delegate.ExecuteIfBound(data); });
+	auto key = AcquireKey(privateKey);
+	MakeReceiveBlock(key, sourceHash, amount, [this, key, delegate](const FMakeBlockResponseData& data) {
+		keys.erase(key);
+		delegate.ExecuteIfBound(data);
+	});
 }
 
-void UNanoManager::MakeReceiveBlock(
-	FString const& privateKey, FString sourceHash, FString const& amount, TFunction<void(FMakeBlockResponseData)> const& delegate) {
-	// Need to construct the block myself
-	nano::raw_key prvKey;
-	prvKey.data = nano::uint256_union(TCHAR_TO_UTF8(*privateKey));
+void UNanoManager::MakeReceiveBlockWithKey(FMakeBlockDelegate delegate, FNanoKey key, FString sourceHash, FString const& amount) {
+	auto handle = AcquireKey(key);
+	MakeReceiveBlock(handle, sourceHash, amount, [this, handle, delegate](const FMakeBlockResponseData& data) {
+		keys.erase(handle);
+		delegate.ExecuteIfBound(data);
+	});
+}
 
-	auto pubKey = nano::pub_key(prvKey.data);
+void UNanoManager::MakeReceiveBlock(nano::keyring::handle key, FString sourceHash, FString const& amount,
+	TFunction<void(FMakeBlockResponseData)> const& delegate) {
+	// Need to construct the block myself
+	auto entry = keys.find(key);
+	if (!entry) {
+		fireMakeBlockDelegateError(delegate);
+		return;
+	}
 
 	// Get the frontier
-	AccountFrontier(pubKey.to_account().c_str(), [this, privateKey, sourceHash, amount, delegate](
-																								 FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful) mutable {
-		auto accountFrontierResponseData = GetAccountFrontierResponseData(request, response, wasSuccessful);
+	auto encodedAccount = KeyAccount(*entry);
+	AccountFrontier(encodedAccount, [this, key, encodedAccount, sourceHash, amount, delegate](TSharedPtr<FJsonObject> const& response) mutable {
+		auto accountFrontierResponseData = GetAccountFrontierResponseData(response, encodedAccount);
 		if (!accountFrontierResponseData.error) {
 			// Generate work
-			WorkGenerate(accountFrontierResponseData.hash, [this, privateKey, sourceHash, amount, delegate, accountFrontierResponseData](
-																											 FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful) {
-				auto workGenerateResponseData = GetWorkGenerateResponseData(request, response, wasSuccessful);
-				if (workGenerateResponseData.hash != "0") {
-					auto prvKey = nano::uint256_union(TCHAR_TO_UTF8(*privateKey));
-					auto thisAccountPublicKey = (nano::pub_key(prvKey));
+			nano::account account;
+			DecodeAccount(accountFrontierResponseData.account, account);
+			CachedWorkGenerate(account, accountFrontierResponseData.hash, FSubtype::receive, [this, key, sourceHash, amount, delegate, accountFrontierResponseData](
+																											 FWorkGenerateResponseData const& workGenerateResponseData) {
+				auto entry = keys.find(key);
+				if (!workGenerateResponseData.error && entry) {
+					auto const& thisAccountPublicKey = entry->pub;
 
 					nano::amount bal;
 					bal.decode_dec(TCHAR_TO_UTF8(*accountFrontierResponseData.balance));
@@ -777,12 +1191,9 @@ void UNanoManager::MakeReceiveBlock(
 					amo.decode_dec(TCHAR_TO_UTF8(*amount));
 
 					FBlock block;
-					block.account = thisAccountPublicKey.to_account().c_str();
+					block.account = KeyAccount(*entry);
 
-					auto str = (bal.number() + amo.number()).ToString();
-					str.RemoveFromStart(TEXT("0x"));
-					block.balance =
-						FString(BaseConverter::HexToDecimalConverter().Convert(std::string(TCHAR_TO_UTF8(*str.ToUpper()))).c_str());
+					block.balance = nano::amount(bal.number() + amo.number()).to_string_dec().c_str();
 
 					block.link = sourceHash;
 
@@ -793,126 +1204,158 @@ void UNanoManager::MakeReceiveBlock(
 						block.previous = accountFrontierResponseData.hash;
 					}
 
-					block.privateKey = privateKey;
+					block.privateKey = entry->prv.data.to_string().c_str();
 					block.representative = accountFrontierResponseData.representative;
 					block.work = workGenerateResponseData.work;
 
 					FMakeBlockResponseData makeBlockData;
 					makeBlockData.block = block;
 					delegate(makeBlockData);
+				} else {
+					fireMakeBlockDelegateError(delegate);
 				}
 			});
 		} else {
-			FMakeBlockResponseData makeBlockData;
-			makeBlockData.error = true;
-			delegate(makeBlockData);
+			fireMakeBlockDelegateError(delegate);
 		}
 	});
 }
 
-FRequestNanoResponseData UNanoManager::GetRequestNanoData(FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful) {
+FNanoKey UNanoManager::RegisterKey(FString const& privateKey) {
+	FNanoKey key;
+	key.handle = AcquireKey(privateKey);
+	return key;
+}
+
+void UNanoManager::UnregisterKey(FNanoKey key) {
+	keys.erase(key.handle);
+}
+
+FString UNanoManager::GetKeyAccount(FNanoKey key) const {
+	auto entry = keys.find(key.handle);
+	return entry ? KeyAccount(*entry) : FString();
+}
+
+nano::keyring::handle UNanoManager::AcquireKey(FString const& privateKey) {
+	FTCHARToUTF8 text(*privateKey);
+	nano::raw_key prvKey;
+	if (prvKey.data.decode_hex(text.Get(), text.Length())) {
+		return nano::keyring::invalid;
+	}
+	return keys.insert(prvKey);
+}
+
+nano::keyring::handle UNanoManager::AcquireKey(FNanoKey key) {
+	return keys.acquire(key.handle) ? nano::keyring::invalid : key.handle;
+}
+
+FRequestNanoResponseData UNanoManager::GetRequestNanoData(TSharedPtr<FJsonObject> const& response, FString const& account) {
 	FRequestNanoResponseData data;
 	RETURN_ERROR_IF_INVALID_RESPONSE(data)
 
-	data.account = reqRespJson.request->GetStringField("account");
-	data.amount = reqRespJson.response->GetStringField("amount");
-	data.srcHash = reqRespJson.response->GetStringField("send_hash");
-	data.frontier = reqRespJson.response->GetStringField("frontier");
+	data.account = account;
+	data.amount = response->GetStringField("amount");
+	data.srcHash = response->GetStringField("send_hash");
+	data.frontier = response->GetStringField("frontier");
 	return data;
 }
 
-FBlockConfirmedResponseData UNanoManager::GetBlockConfirmedResponseData(
-	FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful) {
+FActiveDifficultyResponseData UNanoManager::GetActiveDifficultyResponseData(TSharedPtr<FJsonObject> const& response) {
+	FActiveDifficultyResponseData data;
+	RETURN_ERROR_IF_INVALID_RESPONSE(data)
+
+	data.multiplier = FCString::Atof(*response->GetStringField("multiplier"));
+	data.error = !(data.multiplier > 0);
+	return data;
+}
+
+FBlockConfirmedResponseData UNanoManager::GetBlockConfirmedResponseData(TSharedPtr<FJsonObject> const& response) {
 	FBlockConfirmedResponseData data;
 	RETURN_ERROR_IF_INVALID_RESPONSE(data)
 
-	data.confirmed = reqRespJson.response->GetBoolField("confirmed");
+	data.confirmed = response->GetBoolField("confirmed");
 	return data;
 }
 
 FAccountFrontierResponseData UNanoManager::GetAccountFrontierResponseData(
-	FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful) const {
+	TSharedPtr<FJsonObject> const& response, FString const& account) const {
 	FAccountFrontierResponseData accountFrontierResponseData;
 
-	if (!RequestResponseIsValid(request, response, wasSuccessful)) {
+	if (!response) {
 		accountFrontierResponseData.error = true;
 		return accountFrontierResponseData;
 	}
 
-	auto reqRespJson = GetResponseJson(request, response, wasSuccessful);
-	if (reqRespJson.response->HasField("error")) {
-		if (reqRespJson.request->GetStringField("error") == "1") {
+	accountFrontierResponseData.account = account;
+	if (response->HasField("error")) {
+		if (response->GetStringField("error") == "1") {
 			accountFrontierResponseData.error = true;
 		} else {
 			// Account could not be found, fill in with default values
 			nano::public_key publicKey;
-			publicKey.decode_account(TCHAR_TO_UTF8(*reqRespJson.request->GetStringField("account")));
-			accountFrontierResponseData.account = reqRespJson.request->GetStringField("account");
+			publicKey.decode_account(TCHAR_TO_UTF8(*account));
 			accountFrontierResponseData.hash = publicKey.to_string().c_str();
 
 			accountFrontierResponseData.balance = "0";
 			accountFrontierResponseData.representative = defaultRepresentative;
 		}
 	} else {
-		accountFrontierResponseData.account = reqRespJson.request->GetStringField("account");
-		accountFrontierResponseData.hash = reqRespJson.response->GetStringField("frontier");
-		accountFrontierResponseData.balance = reqRespJson.response->GetStringField("balance");
-		accountFrontierResponseData.representative = reqRespJson.response->GetStringField("representative");
+		accountFrontierResponseData.hash = response->GetStringField("frontier");
+		accountFrontierResponseData.balance = response->GetStringField("balance");
+		accountFrontierResponseData.balanceValue = FNanoAmount::FromRaw(accountFrontierResponseData.balance);
+		accountFrontierResponseData.representative = response->GetStringField("representative");
 	}
 
 	return accountFrontierResponseData;
 }
 
-FGetBalanceResponseData UNanoManager::GetBalanceResponseData(
-	FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful) {
+FGetBalanceResponseData UNanoManager::GetBalanceResponseData(TSharedPtr<FJsonObject> const& response, FString const& account) {
 	FGetBalanceResponseData data;
 	RETURN_ERROR_IF_INVALID_RESPONSE(data)
 
-	data.account = reqRespJson.request->GetStringField("account");
-	data.balance = reqRespJson.response->GetStringField("balance");
-	data.pending = reqRespJson.response->GetStringField("pending");
+	data.account = account;
+	data.balance = response->GetStringField("balance");
+	data.pending = response->GetStringField("pending");
+	data.balanceValue = FNanoAmount::FromRaw(data.balance);
+	data.pendingValue = FNanoAmount::FromRaw(data.pending);
 	return data;
 }
 
-FPendingResponseData UNanoManager::GetPendingResponseData(FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful) {
+FPendingResponseData UNanoManager::GetPendingResponseData(TArray<uint8> const& response, FString const& account) {
 	FPendingResponseData pendingResponseData;
-	RETURN_ERROR_IF_INVALID_RESPONSE(pendingResponseData)
-
-	pendingResponseData.account = reqRespJson.request->GetStringField("account");
+	pendingEntries.clear();
+	if (nano::parse_pending(reinterpret_cast<char const*>(response.GetData()), response.Num(), pendingEntries)) {
+		pendingResponseData.error = true;
+		return pendingResponseData;
+	}
 
-	for (auto currJsonValue = reqRespJson.response->GetObjectField("blocks")->Values.CreateConstIterator(); currJsonValue;
-			 ++currJsonValue) {
-		// Get the key name
+	pendingResponseData.account = account;
+	pendingResponseData.blocks.Reserve(pendingEntries.size());
+	for (auto const& entry : pendingEntries) {
 		FPendingBlock pendingBlock;
-		pendingBlock.hash = (*currJsonValue).Key;
-
-		// Get the value as a FJsonValue object
-		TSharedPtr<FJsonValue> Value = (*currJsonValue).Value;
-		TSharedPtr<FJsonObject> JsonObjectIn = Value->AsObject();
-
-		pendingBlock.amount = JsonObjectIn->GetStringField("amount");
-		pendingBlock.source = JsonObjectIn->GetStringField("source");
-
+		pendingBlock.hash = entry.hash.to_string().c_str();
+		pendingBlock.amount = AmountToRaw(entry.amount);
+		pendingBlock.source = EncodeAccount(entry.source);
+		pendingBlock.amountValue = ToNanoAmount(entry.amount);
 		pendingResponseData.blocks.Add(pendingBlock);
 	}
 	return pendingResponseData;
 }
 
-FWorkGenerateResponseData UNanoManager::GetWorkGenerateResponseData(
-	FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful) {
+FWorkGenerateResponseData UNanoManager::GetWorkGenerateResponseData(TSharedPtr<FJsonObject> const& response, FString const& hash) {
 	FWorkGenerateResponseData data;
+	data.hash = hash;
 	RETURN_ERROR_IF_INVALID_RESPONSE(data);
 
-	data.hash = reqRespJson.request->GetStringField("hash");
-	data.work = reqRespJson.response->GetStringField("work");
+	data.work = response->GetStringField("work");
 	return data;
 }
 
-FProcessResponseData UNanoManager::GetProcessResponseData(FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful) {
+FProcessResponseData UNanoManager::GetProcessResponseData(TSharedPtr<FJsonObject> const& response) {
 	FProcessResponseData data;
 	RETURN_ERROR_IF_INVALID_RESPONSE(data);
 
-	data.hash = reqRespJson.response->GetStringField("hash");
+	data.hash = response->GetStringField("hash");
 	return data;
 }
 
@@ -926,6 +1369,7 @@ void UNanoManager::ListenForPaymentWaitConfirmation(
 
 	listeningPayment.account = account;
 	listeningPayment.amount = amount;
+	listeningPayment.amountValue = FNanoAmount::FromRaw(amount);
 	listeningPayment.delegate = delegate;
 	listeningPayment.timerHandle = FTimerHandle();
 
@@ -939,25 +1383,24 @@ void UNanoManager::ListenForPaymentWaitConfirmation(
 			if (listeningPayment.delegate.IsBound() && listeningPayment.account == account) {
 				// Get a single pending block of at least the minimum amount, if there's there consider payment as going through!
 				Pending(account, TCHAR_TO_UTF8(*listeningPayment.amount), 1,
-					[this, account, websocket](FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful) {
-						auto pendingData = GetPendingResponseData(request, response, wasSuccessful);
-						if (!pendingData.error && pendingData.blocks.Num() > 0) {
-							for (auto pendingBlock : pendingData.blocks) {
-								nano::amount pendingAmount;
-								pendingAmount.decode_dec(TCHAR_TO_UTF8(*pendingBlock.amount));
-								nano::amount listenAmount;
-								listenAmount.decode_dec(TCHAR_TO_UTF8(*listeningPayment.amount));
-
-								// Payment successful! clear and call delegate
-								if ((pendingAmount > listenAmount || pendingAmount == listenAmount) && listeningPayment.account == account &&
-										listeningPayment.delegate.IsBound()) {
-									auto delegate = listeningPayment.delegate;
-									Unwatch(account, listeningPayment.watchId, websocket);
-									GetWorld()->GetTimerManager().ClearTimer(listeningPayment.timerHandle);
-									delegate.ExecuteIfBound(pendingBlock.hash, pendingBlock.amount);
-									delegate.Unbind();
-								}
+					[this, account, websocket](TArray<uint8> const& response) {
+						// Only the first block of at least the amount matters, the parser stops there
+						nano::pending_entry payment;
+						auto found = false;
+						auto error = ParsePending(response, [this, &payment, &found](nano::pending_entry const& entry) {
+							found = ToNanoAmount(entry.amount) >= listeningPayment.amountValue;
+							if (found) {
+								payment = entry;
 							}
+							return found;
+						});
+						// Payment successful! clear and call delegate
+						if (!error && found && listeningPayment.account == account && listeningPayment.delegate.IsBound()) {
+							auto delegate = listeningPayment.delegate;
+							Unwatch(account, listeningPayment.watchId, websocket);
+							GetWorld()->GetTimerManager().ClearTimer(listeningPayment.timerHandle);
+							delegate.ExecuteIfBound(payment.hash.to_string().c_str(), AmountToRaw(payment.amount));
+							delegate.Unbind();
 						}
 					});
 			};
@@ -1010,8 +1453,8 @@ void UNanoManager::ListenPayoutWaitConfirmation(
 				} else {
 					// Check if balance is 0, if so then call delegate
 					GetWalletBalance(
-						account, [this, account, websocket](FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful) {
-							auto balanceResponseData = GetBalanceResponseData(request, response, wasSuccessful);
+						account, [this, account, websocket](TSharedPtr<FJsonObject> const& response) {
+							auto balanceResponseData = GetBalanceResponseData(response, account);
 							if (!balanceResponseData.error && balanceResponseData.balance == "0" && listeningPayout.account == account) {
 								Unwatch(account, listeningPayout.watchId, websocket);
 								if (listeningPayout.delegate.IsBound()) {
@@ -1037,66 +1480,434 @@ void UNanoManager::CancelPayout(FString const& account, UNanoWebsocket* websocke
 	}
 }
 
-TSharedRef<IHttpRequest> UNanoManager::CreateHttpRequest(TSharedPtr<FJsonObject> JsonObject) {
+TSharedRef<IHttpRequest> UNanoManager::CreateHttpRequest() {
 	TSharedRef<IHttpRequest> HttpRequest = FHttpModule::Get().CreateRequest();
 	HttpRequest->SetVerb("POST");
 	HttpRequest->SetHeader(TEXT("User-Agent"), "X-UnrealEngine-Agent");
 	HttpRequest->SetHeader("Content-Type", "application/json");
+	HttpRequest->SetURL(rpcUrl);
+	return HttpRequest;
+}
 
+TSharedRef<IHttpRequest> UNanoManager::CreateHttpRequest(TSharedPtr<FJsonObject> JsonObject) {
 	FString OutputString;
 	TSharedRef<TJsonWriter<>> JsonWriter = TJsonWriterFactory<>::Create(&OutputString);
 	FJsonSerializer::Serialize(JsonObject.ToSharedRef(), JsonWriter);
 
-	HttpRequest->SetURL(rpcUrl);
+	auto HttpRequest = CreateHttpRequest();
 	HttpRequest->SetContentAsString(OutputString);
 	return HttpRequest;
 }
 
+TSharedRef<IHttpRequest> UNanoManager::CreateHttpRequest(TArray<uint8> const& content) {
+	auto HttpRequest = CreateHttpRequest();
+	HttpRequest->SetContent(content);
+	return HttpRequest;
+}
+
+nano::json_writer<UNanoManager::RequestSink> UNanoManager::RequestWriter() {
+	requestContent.Reset();
+	return nano::json_writer<RequestSink>(RequestSink{&requestContent});
+}
+
 void UNanoManager::MakeRequest(
-	TSharedPtr<FJsonObject> JsonObject, TFunction<void(FHttpRequestPtr, FHttpResponsePtr, bool)> delegate) {
-	auto HttpRequest = CreateHttpRequest(JsonObject);
-	HttpRequest->OnProcessRequestComplete().BindLambda(delegate);
+	TSharedPtr<FJsonObject> JsonObject, TFunction<void(TSharedPtr<FJsonObject> const& response)> delegate) {
+	SendRequest(CreateHttpRequest(JsonObject), delegate);
+}
+
+void UNanoManager::MakeRequest(TArray<uint8> const& content, TFunction<void(TSharedPtr<FJsonObject> const& response)> delegate) {
+	nano::uint256_union key;
+	auto inFlight = JoinRequest(content, key);
+	inFlight.first->delegates.Add(MoveTemp(delegate));
+	if (inFlight.second) {
+		SendJoinedRequest(content, key);
+	}
+}
+
+void UNanoManager::MakeRawRequest(TArray<uint8> const& content, TFunction<void(TArray<uint8> const& response)> delegate) {
+	nano::uint256_union key;
+	auto inFlight = JoinRequest(content, key);
+	inFlight.first->rawDelegates.Add(MoveTemp(delegate));
+	if (inFlight.second) {
+		SendJoinedRequest(content, key);
+	}
+}
+
+std::pair<UNanoManager::InFlightRequest*, bool> UNanoManager::JoinRequest(TArray<uint8> const& content, nano::uint256_union& key) {
+	blake2b(key.bytes.data(), key.bytes.size(), content.GetData(), content.Num(), nullptr, 0);
+	auto inFlight = inFlightRequests.emplace(key);
+	if (!inFlight.second) {
+		++rpcRequestsCoalesced;
+	}
+	return inFlight;
+}
+
+void UNanoManager::SendJoinedRequest(TArray<uint8> const& content, nano::uint256_union const& key) {
+	// The delegates are already waiting, so a request which fails straight away still reaches them
+	++rpcRequestsSent;
+	auto HttpRequest = CreateHttpRequest(content);
+	TWeakObjectPtr<UNanoManager> weakThis(this);
+	HttpRequest->OnProcessRequestComplete().BindLambda(
+		[weakThis, key](FHttpRequestPtr, FHttpResponsePtr response, bool wasSuccessful) {
+			if (weakThis.IsValid()) {
+				weakThis->CompleteRequest(key, response, wasSuccessful);
+			}
+		});
 	HttpRequest->ProcessRequest();
 }
 
-auto UNanoManager::GetResponseJson(FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful) -> ReqRespJson {
-	// Make sure we are getting json
-	ReqRespJson reqRespJson;
+void UNanoManager::CompleteRequest(nano::uint256_union const& key, FHttpResponsePtr response, bool wasSuccessful) {
+	// Taken out before any delegate runs, so the ones which make the same request again start a new one
+	InFlightRequest inFlight;
+	if (auto existing = inFlightRequests.find(key)) {
+		inFlight = MoveTemp(*existing);
+		inFlightRequests.erase(key);
+	}
 
-	if (!wasSuccessful || !response.IsValid()) {
-		return reqRespJson;
+	if (inFlight.delegates.Num() > 0) {
+		auto json = ParseResponse(response, wasSuccessful);
+		for (auto const& delegate : inFlight.delegates) {
+			delegate(json);
+		}
 	}
+	if (inFlight.rawDelegates.Num() > 0) {
+		TArray<uint8> empty;
+		auto ok = wasSuccessful && response.IsValid() && EHttpResponseCodes::IsOk(response->GetResponseCode());
+		if (!ok && inFlight.delegates.Num() == 0 && wasSuccessful && response.IsValid()) {
+			UE_LOG(LogTemp, Warning, TEXT("Http Response returned error code: %d"), response->GetResponseCode());
+		}
+		for (auto const& delegate : inFlight.rawDelegates) {
+			delegate(ok ? response->GetContent() : empty);
+		}
+	}
+}
 
-	if (request->GetContentType() == "application/json" && response->GetContentType().StartsWith("application/json")) {
-		// Response
-		TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(response->GetContentAsString());
+void UNanoManager::QueueRequest(RpcBatchKind kind, BatchedRequest request) {
+	auto invalid = false;
+	if (kind == RpcBatchKind::blockInfo) {
+		FTCHARToUTF8 text(*request.text);
+		invalid = request.key.decode_hex(text.Get(), text.Length());
+	} else {
+		invalid = DecodeAccount(request.text, request.key);
+	}
 
-		if (FJsonSerializer::Deserialize(Reader, reqRespJson.response)) {
-			// Request
-			auto length = request->GetContentLength();
-			auto content = request->GetContent();
-			auto originalRequest = BytesToStringFixed(content.GetData(), length);
+	// An invalid account or hash would fail the whole batch, on its own only its request gets the node's error
+	auto world = GetWorld();
+	if (rpcBatchWindow <= 0.0f || rpcMaxBatch < 2 || !world || invalid) {
+		SendUnbatched(kind, request);
+		return;
+	}
+
+	auto name = FString::Printf(TEXT("%d"), static_cast<int32>(kind));
+	if (kind == RpcBatchKind::pending) {
+		name += FString::Printf(TEXT(" %d %s"), request.count, *request.threshold);
+	}
+	auto& batch = requestBatches.FindOrAdd(name);
+	if (!batch) {
+		batch = MakeShared<RequestBatch>();
+		batch->kind = kind;
+		TWeakObjectPtr<UNanoManager> weakThis(this);
+		world->GetTimerManager().SetTimer(
+			batch->timer,
+			[weakThis, name]() {
+				if (weakThis.IsValid()) {
+					weakThis->FlushBatch(name);
+				}
+			},
+			rpcBatchWindow, false);
+	}
+	batch->requests.Add(MoveTemp(request));
+	if (batch->requests.Num() >= rpcMaxBatch) {
+		FlushBatch(name);
+	}
+}
+
+void UNanoManager::FlushBatch(FString const& name) {
+	TSharedPtr<RequestBatch> batch;
+	if (!requestBatches.RemoveAndCopyValue(name, batch)) {
+		return;
+	}
+	if (auto world = GetWorld()) {
+		world->GetTimerManager().ClearTimer(batch->timer);
+	}
+	if (batch->requests.Num() == 1) {
+		SendUnbatched(batch->kind, batch->requests[0]);
+		return;
+	}
+
+	// Each account or hash once, however many requests are waiting on it
+	nano::key_map<bool> added;
+	std::vector<nano::uint256_union> keys;
+	keys.reserve(batch->requests.Num());
+	for (auto const& request : batch->requests) {
+		if (added.emplace(request.key).second) {
+			keys.push_back(request.key);
+		}
+	}
+
+	TWeakObjectPtr<UNanoManager> weakThis(this);
+	switch (batch->kind) {
+		case RpcBatchKind::balance: {
+			auto writer = RequestWriter();
+			nano::rpc::accounts(writer, "accounts_balances", keys.data(), keys.size(), true);
+			MakeRequest(requestContent, [weakThis, batch](TSharedPtr<FJsonObject> const& response) {
+				if (weakThis.IsValid()) {
+					weakThis->FanOutBatch(*batch, response, TEXT("balances"));
+				}
+			});
+			break;
+		}
+		case RpcBatchKind::blockInfo: {
+			auto writer = RequestWriter();
+			nano::rpc::blocks_info(writer, keys.data(), keys.size());
+			MakeRequest(requestContent, [weakThis, batch](TSharedPtr<FJsonObject> const& response) {
+				if (weakThis.IsValid()) {
+					weakThis->FanOutBatch(*batch, response, TEXT("blocks"));
+				}
+			});
+			break;
+		}
+		case RpcBatchKind::pending: {
+			auto const& first = batch->requests[0];
+			FTCHARToUTF8 threshold(*first.threshold);
+			auto writer = RequestWriter();
+			nano::rpc::accounts_pending(writer, keys.data(), keys.size(), first.count, threshold.Get(), threshold.Length());
+			MakeRawRequest(requestContent, [weakThis, batch](TArray<uint8> const& response) {
+				if (weakThis.IsValid()) {
+					weakThis->FanOutPending(*batch, response);
+				}
+			});
+			break;
+		}
+		case RpcBatchKind::frontier: {
+			auto writer = RequestWriter();
+			nano::rpc::accounts(writer, "accounts_frontiers", keys.data(), keys.size(), false);
+			MakeRequest(requestContent, [weakThis, batch](TSharedPtr<FJsonObject> const& response) {
+				if (weakThis.IsValid()) {
+					weakThis->LookupFrontierBlocks(batch, response);
+				}
+			});
+			break;
+		}
+	}
+}
+
+void UNanoManager::SendUnbatched(RpcBatchKind kind, BatchedRequest const& request) {
+	FTCHARToUTF8 text(*request.text);
+	auto writer = RequestWriter();
+	switch (kind) {
+		case RpcBatchKind::balance:
+			nano::rpc::account_balance(writer, text.Get(), text.Length());
+			break;
+		case RpcBatchKind::frontier:
+			nano::rpc::account_info(writer, text.Get(), text.Length());
+			break;
+		case RpcBatchKind::blockInfo:
+			nano::rpc::block_info(writer, text.Get(), text.Length());
+			break;
+		case RpcBatchKind::pending: {
+			FTCHARToUTF8 threshold(*request.threshold);
+			nano::rpc::pending(writer, text.Get(), text.Length(), request.count, threshold.Get(), threshold.Length());
+			MakeRawRequest(requestContent, request.rawDelegate);
+			return;
+		}
+	}
+	MakeRequest(requestContent, request.delegate);
+}
+
+void UNanoManager::FanOutBatch(RequestBatch const& batch, TSharedPtr<FJsonObject> const& response, TCHAR const* field) {
+	// Nothing came back, resending each would only fail the same way
+	if (!response) {
+		for (auto const& request : batch.requests) {
+			request.delegate(response);
+		}
+		return;
+	}
+
+	auto results = ResultsByKey(response, field, batch.kind == RpcBatchKind::blockInfo);
+	for (auto const& request : batch.requests) {
+		auto result = results.find(request.key);
+		TSharedPtr<FJsonObject> const* object;
+		if (result && (*result)->TryGetObject(object)) {
+			++rpcRequestsBatched;
+			request.delegate(*object);
+		} else {
+			SendUnbatched(batch.kind, request);
+		}
+	}
+}
+
+void UNanoManager::LookupFrontierBlocks(TSharedPtr<RequestBatch> const& batch, TSharedPtr<FJsonObject> const& frontiers) {
+	std::vector<nano::block_hash> hashes;
+	if (frontiers && !frontiers->HasField("error")) {
+		auto results = ResultsByKey(frontiers, TEXT("frontiers"), false);
+		results.for_each([&hashes](nano::account const&, TSharedPtr<FJsonValue> const& value) {
+			nano::block_hash hash;
+			FTCHARToUTF8 text(*value->AsString());
+			if (!hash.decode_hex(text.Get(), text.Length())) {
+				hashes.push_back(hash);
+			}
+		});
+	}
+	if (hashes.empty()) {
+		// Failed, or none of the accounts are opened
+		FanOutFrontiers(*batch, frontiers, nullptr);
+		return;
+	}
 
-			TSharedRef<TJsonReader<>> requestReader = TJsonReaderFactory<>::Create(originalRequest);
+	auto writer = RequestWriter();
+	nano::rpc::blocks_info(writer, hashes.data(), hashes.size());
+	TWeakObjectPtr<UNanoManager> weakThis(this);
+	MakeRequest(requestContent, [weakThis, batch, frontiers](TSharedPtr<FJsonObject> const& blocks) {
+		if (weakThis.IsValid()) {
+			weakThis->FanOutFrontiers(*batch, frontiers, blocks);
+		}
+	});
+}
+
+void UNanoManager::FanOutFrontiers(
+	RequestBatch const& batch, TSharedPtr<FJsonObject> const& frontiers, TSharedPtr<FJsonObject> const& blocks) {
+	if (!frontiers) {
+		for (auto const& request : batch.requests) {
+			request.delegate(nullptr);
+		}
+		return;
+	}
+
+	auto frontierResults = ResultsByKey(frontiers, TEXT("frontiers"), false);
+	auto blockResults = ResultsByKey(blocks, TEXT("blocks"), true);
+	for (auto const& request : batch.requests) {
+		auto frontier = frontierResults.find(request.key);
+		TSharedPtr<FJsonValue> const* block = nullptr;
+		if (frontier) {
+			nano::block_hash hash;
+			FTCHARToUTF8 text(*(*frontier)->AsString());
+			if (!hash.decode_hex(text.Get(), text.Length())) {
+				block = blockResults.find(hash);
+			}
+		}
+		TSharedPtr<FJsonObject> const* blockObject;
+		TSharedPtr<FJsonObject> const* contents;
+		if (frontiers->HasField("error")) {
+			SendUnbatched(batch.kind, request);
+		} else if (!frontier) {
+			// Unopened, which is what account_info answers for it
+			++rpcRequestsBatched;
+			auto json = MakeShared<FJsonObject>();
+			json->SetStringField("error", "Account not found");
+			request.delegate(json);
+		} else if (block && (*block)->TryGetObject(blockObject) && (*blockObject)->TryGetObjectField("contents", contents)) {
+			++rpcRequestsBatched;
+			auto json = MakeShared<FJsonObject>();
+			json->SetStringField("frontier", (*frontier)->AsString());
+			json->SetStringField("balance", (*blockObject)->GetStringField("balance"));
+			json->SetStringField("representative", (*contents)->GetStringField("representative"));
+			request.delegate(json);
+		} else {
+			// blocks_info failed, or the account moved on and its old frontier is gone
+			SendUnbatched(batch.kind, request);
+		}
+	}
+}
+
+void UNanoManager::FanOutPending(RequestBatch const& batch, TArray<uint8> const& response) {
+	if (response.Num() == 0) {
+		for (auto const& request : batch.requests) {
+			request.rawDelegate(response);
+		}
+		return;
+	}
+
+	nano::key_map<std::pair<char const*, size_t>> blocks;
+	auto error = nano::parse_accounts_pending(reinterpret_cast<char const*>(response.GetData()), response.Num(),
+		[&blocks](char const* account, size_t accountLength, char const* text, size_t length) {
+			nano::account key;
+			if (!key.decode_account(account, accountLength)) {
+				blocks.emplace(key, text, length);
+			}
+		});
+
+	if (error) {
+		for (auto const& request : batch.requests) {
+			SendUnbatched(batch.kind, request);
+		}
+		return;
+	}
+
+	// Each account's blocks are wrapped up as its own pending response, accounts the node left out have none
+	rpcRequestsBatched += batch.requests.Num();
+	static char const prefix[] = "{\"blocks\":";
+	static char const none[] = "\"\"";
+	TArray<uint8> single;
+	for (auto const& request : batch.requests) {
+		auto entry = blocks.find(request.key);
+		single.Reset();
+		single.Append(reinterpret_cast<uint8 const*>(prefix), sizeof(prefix) - 1);
+		if (entry) {
+			single.Append(reinterpret_cast<uint8 const*>(entry->first), static_cast<int32>(entry->second));
+		} else {
+			single.Append(reinterpret_cast<uint8 const*>(none), sizeof(none) - 1);
+		}
+		single.Add('}');
+		request.rawDelegate(single);
+	}
+}
 
-			// Might not work
-			FJsonSerializer::Deserialize(requestReader, reqRespJson.request);
+nano::key_map<TSharedPtr<FJsonValue>> UNanoManager::ResultsByKey(
+	TSharedPtr<FJsonObject> const& response, TCHAR const* field, bool hashes) {
+	nano::key_map<TSharedPtr<FJsonValue>> results;
+	TSharedPtr<FJsonObject> const* object;
+	if (response && !response->HasField("error") && response->TryGetObjectField(field, object)) {
+		for (auto const& entry : (*object)->Values) {
+			nano::uint256_union key;
+			auto error = false;
+			if (hashes) {
+				FTCHARToUTF8 text(*entry.Key);
+				error = key.decode_hex(text.Get(), text.Length());
+			} else {
+				error = DecodeAccount(entry.Key, key);
+			}
+			if (!error) {
+				results.emplace(key, entry.Value);
+			}
 		}
 	}
-	return reqRespJson;
+	return results;
+}
+
+float UNanoManager::GetRpcCoalescedRatio() const {
+	auto total = rpcRequestsSent + rpcRequestsCoalesced;
+	return total > 0 ? static_cast<float>(rpcRequestsCoalesced) / total : 0.0f;
 }
 
-bool UNanoManager::RequestResponseIsValid(FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful) {
+void UNanoManager::SendRequest(TArray<uint8> const& content, TFunction<void(TSharedPtr<FJsonObject> const& response)> delegate) {
+	SendRequest(CreateHttpRequest(content), delegate);
+}
+
+void UNanoManager::SendRequest(
+	TSharedRef<IHttpRequest> const& HttpRequest, TFunction<void(TSharedPtr<FJsonObject> const& response)> delegate) {
+	++rpcRequestsSent;
+	HttpRequest->OnProcessRequestComplete().BindLambda([delegate](FHttpRequestPtr, FHttpResponsePtr response, bool wasSuccessful) {
+		delegate(ParseResponse(response, wasSuccessful));
+	});
+	HttpRequest->ProcessRequest();
+}
+
+TSharedPtr<FJsonObject> UNanoManager::ParseResponse(FHttpResponsePtr response, bool wasSuccessful) {
+	TSharedPtr<FJsonObject> json;
 	if (!wasSuccessful || !response.IsValid()) {
-		return false;
+		return json;
 	}
-	if (EHttpResponseCodes::IsOk(response->GetResponseCode())) {
-		auto reqRespJson = GetResponseJson(request, response, wasSuccessful);
-		return (reqRespJson.request && reqRespJson.response);
-	} else {
+
+	if (!EHttpResponseCodes::IsOk(response->GetResponseCode())) {
 		UE_LOG(LogTemp, Warning, TEXT("Http Response returned error code: %d"), response->GetResponseCode());
-		return false;
+	} else if (response->GetContentType().StartsWith("application/json")) {
+		TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(response->GetContentAsString());
+		if (!FJsonSerializer::Deserialize(Reader, json)) {
+			json.Reset();
+		}
 	}
+	return json;
 }
 
 FString UNanoManager::getDefaultDataPath() const {
@@ -1133,6 +1944,10 @@ FString UNanoManager::getDefaultDataPath() const {
 void UNanoManager::SetDataSubdirectory(FString const& subdir) {
 	auto defaultPath = getDefaultDataPath();
 	dataPath = FPaths::Combine(defaultPath, subdir);
+
+	// The work cache lives in the data path too, load the new one when it's next needed
+	workCacheFile.Reset();
+	workCacheLoaded = false;
 }
 
 int32 UNanoManager::GetNumSeedFiles() const {
@@ -1146,7 +1961,10 @@ TArray<FString> UNanoManager::GetSeedFiles() const {
 	TArray<FString> files;
 	platformFile.IterateDirectory(*dataPath, [&files](const TCHAR* fileOrDir, bool isDirectory) {
 		if (!isDirectory) {
-			files.Add(fileOrDir);
+			// Skip the work cache and any copy of it left by a crash while rewriting
+			if (!FPaths::GetCleanFilename(fileOrDir).StartsWith(WorkCacheFileName)) {
+				files.Add(fileOrDir);
+			}
 			return true;
 		}
 
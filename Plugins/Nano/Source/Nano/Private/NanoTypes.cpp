@@ -0,0 +1,34 @@
+// Copyright 2020 Wesley Shillingford. All rights reserved.
+#include "NanoTypes.h"
+
+#include <nano/codecs.h>
+#include <nano/numbers.h>
+
+#include <array>
+
+FNanoAmount FNanoAmount::FromRaw(const FString& raw) {
+	FNanoAmount amount;
+	FromRaw(raw, amount);
+	return amount;
+}
+
+bool FNanoAmount::FromRaw(const FString& raw, FNanoAmount& amount) {
+	FTCHARToUTF8 utf8(*raw);
+	nano::amount number;
+	auto error = number.decode_dec_n(utf8.Get(), utf8.Length(), true);
+	if (!error) {
+		auto value = number.number();
+		amount.low = value.limbs[0];
+		amount.high = value.limbs[1];
+	}
+	return error;
+}
+
+FString FNanoAmount::ToRaw() const {
+	nano::uint128_t value;
+	value.limbs[0] = low;
+	value.limbs[1] = high;
+	std::array<char, 39> text;
+	auto length = nano::amount(value).encode_dec(text);
+	return FString(static_cast<int32>(length), text.data());
+}
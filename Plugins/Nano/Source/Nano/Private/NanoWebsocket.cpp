@@ -1,6 +1,7 @@
 // Copyright 2020 Wesley Shillingford. All rights reserved.
 #include "NanoWebsocket.h"
 
+#include "Async/Async.h"
 #include "Engine/World.h"
 #include "Json.h"
 #include "JsonObjectConverter.h"
@@ -13,6 +14,8 @@
 #include <nano/blocks.h>
 #include <nano/numbers.h>
 
+#include <vector>
+
 namespace {
 template <typename T>
 FString MakeOutputString(T const& ustruct) {
@@ -24,6 +27,17 @@ FString MakeOutputString(T const& ustruct) {
 }
 }	 // namespace
 
+bool UNanoWebsocket::DecodeAccount(FString const& account, nano::account& key) {
+	FTCHARToUTF8 utf8(*account);
+	return accounts.decode(utf8.Get(), utf8.Length(), key);
+}
+
+FString UNanoWebsocket::EncodeAccount(nano::account const& key) {
+	std::array<char, 65> text;
+	accounts.encode(key, text);
+	return FString(static_cast<int32>(text.size()), text.data());
+}
+
 void UNanoWebsocket::BeginDestroy() {
 	Super::BeginDestroy();
 
@@ -44,11 +58,11 @@ void UNanoWebsocket::Connect(const FString& wsURL, FWebsocketConnectedDelegate d
 
 	// This is when a connection is successfully made.
 	Websocket->OnConnected().AddLambda([delegate, this]() -> void {
-		for (auto const& accountNumPair : registeredAccounts) {
+		registeredAccounts.for_each([this](nano::account const& account, int) {
 			FRegisterAccountRequestData registerAccount;
-			registerAccount.account = accountNumPair.Key;
+			registerAccount.account = EncodeAccount(account);
 			Websocket->Send(MakeOutputString(registerAccount));
-		}
+		});
 
 		if (isListeningAll) {
 			ListenAll();
@@ -97,6 +111,7 @@ void UNanoWebsocket::Connect(const FString& wsURL, FWebsocketConnectedDelegate d
 				data.account = messageJson->GetStringField("account");
 				data.amount = messageJson->GetStringField("amount");
 				data.hash = messageJson->GetStringField("hash");
+				data.amountValue = FNanoAmount::FromRaw(data.amount);
 
 				auto blockJson = messageJson->GetObjectField("block");
 
@@ -106,6 +121,7 @@ void UNanoWebsocket::Connect(const FString& wsURL, FWebsocketConnectedDelegate d
 				data.block.previous = blockJson->GetStringField("previous");
 				data.block.representative = blockJson->GetStringField("representative");
 				data.block.work = blockJson->GetStringField("work");
+				data.block.signature = blockJson->GetStringField("signature");
 
 				auto subtypeStr = blockJson->GetStringField("subtype");
 				// If there's no subtype, it means it's not a state block
@@ -127,10 +143,11 @@ void UNanoWebsocket::Connect(const FString& wsURL, FWebsocketConnectedDelegate d
 					data.block.subtype = subtype;
 
 					auto isFiltered = response->GetBoolField("is_filtered");
-					if (isFiltered) {
-						onFilteredResponse.Broadcast(data, this);
+					// Epoch blocks are signed by the epoch signer rather than the account
+					if (verifySignatures && subtype != FSubtype::epoch) {
+						QueueVerification(data, isFiltered);
 					} else {
-						onResponse.Broadcast(data, this);
+						Broadcast(data, isFiltered);
 					}
 				} else {
 					UE_LOG(LogTemp, Warning,
@@ -153,13 +170,103 @@ void UNanoWebsocket::Connect(const FString& wsURL, FWebsocketConnectedDelegate d
 		5.0f, true, 5.f);
 }
 
+void UNanoWebsocket::Broadcast(FWebsocketConfirmationResponseData const& data, bool isFiltered) {
+	if (isFiltered) {
+		onFilteredResponse.Broadcast(data, this);
+	} else {
+		onResponse.Broadcast(data, this);
+	}
+}
+
+void UNanoWebsocket::QueueVerification(FWebsocketConfirmationResponseData const& data, bool isFiltered) {
+	PendingConfirmation pending{data, isFiltered};
+
+	nano::state_block block;
+	auto& hashables = block.hashables;
+	FTCHARToUTF8 previous(*data.block.previous);
+	FTCHARToUTF8 balance(*data.block.balance);
+	FTCHARToUTF8 link(*data.block.link);
+	FTCHARToUTF8 signature(*data.block.signature);
+	auto error = DecodeAccount(data.block.account, hashables.account) ||
+							 DecodeAccount(data.block.representative, hashables.representative) ||
+							 hashables.previous.decode_hex(previous.Get(), previous.Length()) ||
+							 hashables.balance.decode_dec_n(balance.Get(), balance.Length()) ||
+							 hashables.link.decode_hex(link.Get(), link.Length()) ||
+							 pending.signature.decode_hex(signature.Get(), signature.Length());
+	if (error) {
+		++rejectedConfirmations;
+		UE_LOG(LogTemp, Warning, TEXT("Dropping confirmation with an invalid block: %s"), *data.hash);
+		return;
+	}
+
+	pending.account = hashables.account;
+	pending.hash = block.hash();
+	pendingVerification.Add(MoveTemp(pending));
+
+	if (pendingVerification.Num() >= static_cast<int32>(nano::signature_batch_size)) {
+		VerifyPending();
+	} else if (pendingVerification.Num() == 1) {
+		// Give the rest of the messages received this frame a chance to join the batch
+		TWeakObjectPtr<UNanoWebsocket> weakThis(this);
+		AsyncTask(ENamedThreads::GameThread, [weakThis]() {
+			if (weakThis.IsValid()) {
+				weakThis->VerifyPending();
+			}
+		});
+	}
+}
+
+void UNanoWebsocket::VerifyPending() {
+	if (verifying || pendingVerification.Num() == 0) {
+		return;
+	}
+
+	verifying = true;
+	TWeakObjectPtr<UNanoWebsocket> weakThis(this);
+	Async(EAsyncExecution::ThreadPool, [weakThis, batch = MoveTemp(pendingVerification)]() mutable {
+		std::vector<nano::block_hash> hashes;
+		std::vector<nano::account> accounts;
+		std::vector<nano::signature> signatures;
+		for (auto const& pending : batch) {
+			hashes.push_back(pending.hash);
+			accounts.push_back(pending.account);
+			signatures.push_back(pending.signature);
+		}
+		auto valid = nano::validate_signatures(hashes, accounts, signatures);
+
+		AsyncTask(ENamedThreads::GameThread, [weakThis, batch = MoveTemp(batch), valid = MoveTemp(valid)]() {
+			if (!weakThis.IsValid()) {
+				return;
+			}
+			auto websocket = weakThis.Get();
+			websocket->verifying = false;
+			for (auto i = 0; i < batch.Num(); ++i) {
+				if (valid[i]) {
+					websocket->Broadcast(batch[i].data, batch[i].isFiltered);
+				} else {
+					++websocket->rejectedConfirmations;
+					UE_LOG(LogTemp, Warning, TEXT("Dropping confirmation with an invalid signature: %s"), *batch[i].data.hash);
+				}
+			}
+			websocket->VerifyPending();
+		});
+	});
+	pendingVerification.Reset();
+}
+
 void UNanoWebsocket::RegisterAccount(const FString& account) {
-	auto val = registeredAccounts.Find(account);
+	nano::account key;
+	if (DecodeAccount(account, key)) {
+		UE_LOG(LogTemp, Warning, TEXT("Cannot register invalid account: %s"), *account);
+		return;
+	}
+
+	auto val = registeredAccounts.find(key);
 	if (val != nullptr) {
 		// Just increment the number of listeners
 		++*val;
 	} else {
-		registeredAccounts.Emplace(account, 1);
+		registeredAccounts.emplace(key, 1);
 		if (!Websocket->IsConnected()) {
 			// Don't send if we're not connected.
 			return;
@@ -173,12 +280,13 @@ void UNanoWebsocket::RegisterAccount(const FString& account) {
 }
 
 void UNanoWebsocket::UnregisterAccount(const FString& account) {
-	auto val = registeredAccounts.Find(account);
+	nano::account key;
+	auto val = !DecodeAccount(account, key) ? registeredAccounts.find(key) : nullptr;
 	if (val) {
 		if (*val > 1) {
 			--*val;
 		} else {
-			registeredAccounts.Remove(account);
+			registeredAccounts.erase(key);
 
 			if (!Websocket->IsConnected()) {
 				// Don't send if we're not connected.
@@ -152,6 +152,10 @@ extern "C" {
   int blake2b_update( blake2b_state *S, const void *in, size_t inlen );
   int blake2b_final( blake2b_state *S, void *out, size_t outlen );
 
+  /* Compresses one block. This forwards to the SIMD version nano/blake2b.cpp selected for the cpu, or the reference one */
+  void blake2b_compress( blake2b_state *S, const uint8_t block[BLAKE2B_BLOCKBYTES] );
+  void blake2b_compress_ref( blake2b_state *S, const uint8_t block[BLAKE2B_BLOCKBYTES] );
+
   int blake2sp_init( blake2sp_state *S, size_t outlen );
   int blake2sp_init_key( blake2sp_state *S, size_t outlen, const void *key, size_t keylen );
   int blake2sp_update( blake2sp_state *S, const void *in, size_t inlen );
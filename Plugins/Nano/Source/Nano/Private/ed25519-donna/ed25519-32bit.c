@@ -0,0 +1,10 @@
+/*
+	The 32-bit limb backend, built alongside the default one in ed25519.c with its public functions suffixed so
+	nano/ed25519_backends.cpp can choose between them at runtime. On 32-bit targets it is the same as the default
+*/
+#define ED25519_FORCE_32BIT
+#define ED25519_SUFFIX _32bit
+/* The custom random bytes are shared by every backend, the other global gets its own copy */
+#define ed25519_randombytes_unsafe_32bit ed25519_randombytes_unsafe
+#define batch_point_buffer batch_point_buffer_32bit
+#include "ed25519.c"
@@ -9,9 +9,10 @@
 	void ed25519_hash(uint8_t *hash, const uint8_t *in, size_t inlen);
 */
 
+/* Storage for a blake2b_state, which blake2.h can't declare for C. Kept inline so hashing never allocates */
 typedef struct ed25519_hash_context_t
 {
-    void * blake2;
+    uint64_t blake2[31];
 } ed25519_hash_context;
 
 void ed25519_hash_init (ed25519_hash_context * ctx);
@@ -0,0 +1,12 @@
+/*
+	The SSE2 backend, built alongside the default one in ed25519.c with its public functions suffixed so nano/ed25519_backends.cpp
+	can choose between them at runtime
+*/
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ED25519_SSE2
+#define ED25519_SUFFIX _sse2
+/* The custom random bytes are shared by every backend, the other global gets its own copy */
+#define ed25519_randombytes_unsafe_sse2 ed25519_randombytes_unsafe
+#define batch_point_buffer batch_point_buffer_sse2
+#include "ed25519.c"
+#endif
@@ -0,0 +1,178 @@
+// Copyright 2020 Wesley Shillingford. All rights reserved.
+#include <nano/account_cache.h>
+
+#include <cstring>
+
+namespace
+{
+uint32_t const none (static_cast<uint32_t> (-1));
+size_t const prefix_length (5);
+
+/** Where the 60 character body starts, nullptr if this doesn't look like an account */
+char const * account_body (char const * text_a, size_t length_a)
+{
+	char const * result (nullptr);
+	if (length_a == 65 && std::memcmp (text_a, "nano", 4) == 0 && (text_a[4] == '_' || text_a[4] == '-'))
+	{
+		result = text_a + 5;
+	}
+	else if (length_a == 64 && std::memcmp (text_a, "xrb", 3) == 0 && (text_a[3] == '_' || text_a[3] == '-'))
+	{
+		result = text_a + 4;
+	}
+	return result;
+}
+}
+
+nano::account_cache::account_cache (size_t capacity_a) :
+capacity (capacity_a),
+newest (none),
+oldest (none)
+{
+	check (capacity_a > 0 && capacity_a < none);
+	entries.reserve (capacity_a);
+}
+
+bool nano::account_cache::decode (char const * text_a, size_t length_a, nano::account & account_a)
+{
+	auto body_l (account_body (text_a, length_a));
+	auto cached (body_l != nullptr ? by_text.find (text_key (body_l)) : nullptr);
+	auto error (false);
+	if (cached != nullptr && std::memcmp (entries[*cached].text.data (), body_l, sizeof (body)) == 0)
+	{
+		++hits;
+		account_a = entries[*cached].account;
+		touch (*cached);
+	}
+	else
+	{
+		++misses;
+		error = account_a.decode_account (text_a, length_a);
+		if (!error)
+		{
+			insert (account_a, body_l);
+		}
+	}
+	return error;
+}
+
+void nano::account_cache::encode (nano::account const & account_a, std::array<char, 65> & text_a)
+{
+	auto cached (by_account.find (account_a));
+	if (cached != nullptr)
+	{
+		++hits;
+		std::memcpy (text_a.data (), "nano_", prefix_length);
+		std::memcpy (text_a.data () + prefix_length, entries[*cached].text.data (), sizeof (body));
+		touch (*cached);
+	}
+	else
+	{
+		++misses;
+		account_a.encode_account (text_a);
+		insert (account_a, text_a.data () + prefix_length);
+	}
+}
+
+size_t nano::account_cache::size () const
+{
+	return entries.size ();
+}
+
+nano::uint256_union nano::account_cache::text_key (char const * body_a)
+{
+	// Fold the characters into 32 bytes, the full text is compared on lookup
+	nano::uint256_union result (0);
+	for (size_t i (0); i < sizeof (body); ++i)
+	{
+		result.bytes[i % result.bytes.size ()] ^= static_cast<uint8_t> (body_a[i]);
+	}
+	return result;
+}
+
+void nano::account_cache::insert (nano::account const & account_a, char const * body_a)
+{
+	auto existing (by_account.find (account_a));
+	if (existing != nullptr)
+	{
+		touch (*existing);
+	}
+	else
+	{
+		uint32_t index;
+		if (entries.size () < capacity)
+		{
+			index = static_cast<uint32_t> (entries.size ());
+			entries.emplace_back ();
+		}
+		else
+		{
+			// Reuse the least recently used entry
+			index = oldest;
+			unlink (index);
+			by_account.erase (entries[index].account);
+			auto key (text_key (entries[index].text.data ()));
+			auto text_index (by_text.find (key));
+			if (text_index != nullptr && *text_index == index)
+			{
+				by_text.erase (key);
+			}
+		}
+		auto & entry_l (entries[index]);
+		entry_l.account = account_a;
+		std::memcpy (entry_l.text.data (), body_a, sizeof (body));
+		entry_l.newer = none;
+		entry_l.older = newest;
+		if (newest != none)
+		{
+			entries[newest].newer = index;
+		}
+		newest = index;
+		if (oldest == none)
+		{
+			oldest = index;
+		}
+		by_account.emplace (account_a, index);
+		// Two bodies folding to the same key is astronomically unlikely, the newest one wins
+		auto text_index (by_text.emplace (text_key (body_a), index));
+		*text_index.first = index;
+	}
+}
+
+void nano::account_cache::touch (uint32_t index_a)
+{
+	if (index_a != newest)
+	{
+		unlink (index_a);
+		auto & entry_l (entries[index_a]);
+		entry_l.newer = none;
+		entry_l.older = newest;
+		entries[newest].newer = index_a;
+		newest = index_a;
+		if (oldest == none)
+		{
+			oldest = index_a;
+		}
+	}
+}
+
+void nano::account_cache::unlink (uint32_t index_a)
+{
+	auto & entry_l (entries[index_a]);
+	if (entry_l.older != none)
+	{
+		entries[entry_l.older].newer = entry_l.newer;
+	}
+	else
+	{
+		oldest = entry_l.newer;
+	}
+	if (entry_l.newer != none)
+	{
+		entries[entry_l.newer].older = entry_l.older;
+	}
+	else
+	{
+		newest = entry_l.older;
+	}
+}
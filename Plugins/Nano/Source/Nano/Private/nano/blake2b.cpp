@@ -0,0 +1,330 @@
+// Copyright 2020 Wesley Shillingford. All rights reserved.
+#include <nano/blake2b.h>
+#include <nano/cpu.h>
+
+#include <blake2/blake2.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#if defined(NANO_SSE2)
+#include <immintrin.h>
+#endif
+
+namespace
+{
+using compress_function = void (*) (blake2b_state *, uint8_t const *);
+
+uint64_t constexpr blake2b_iv[8] = {
+	0x6a09e667f3bcc908, 0xbb67ae8584caa73b, 0x3c6ef372fe94f82b, 0xa54ff53a5f1d36f1,
+	0x510e527fade682d1, 0x9b05688c2b3e6c1f, 0x1f83d9abfb41bd6b, 0x5be0cd19137e2179
+};
+
+uint8_t constexpr blake2b_sigma[12][16] = {
+	{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+	{ 14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3 },
+	{ 11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4 },
+	{ 7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8 },
+	{ 9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13 },
+	{ 2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9 },
+	{ 12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11 },
+	{ 13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10 },
+	{ 6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5 },
+	{ 10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0 },
+	{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+	{ 14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3 }
+};
+
+#if defined(NANO_SSE2)
+// One G function on each pair of lanes, mx_a and my_a hold the two message words of every lane
+// clang-format off
+#define NANO_BLAKE2B_G(a, b, c, d, mx_a, my_a) \
+	a = ADD (ADD (a, b), mx_a); d = ROT32 (XOR (d, a)); c = ADD (c, d); b = ROT24 (XOR (b, c)); \
+	a = ADD (ADD (a, b), my_a); d = ROT16 (XOR (d, a)); c = ADD (c, d); b = ROT63 (XOR (b, c));
+// clang-format on
+
+#define ADD(a, b) _mm_add_epi64 (a, b)
+#define XOR(a, b) _mm_xor_si128 (a, b)
+#define ROT32(a) _mm_shuffle_epi32 (a, _MM_SHUFFLE (2, 3, 0, 1))
+#define ROT24(a) _mm_shuffle_epi8 (a, rot24)
+#define ROT16(a) _mm_shuffle_epi8 (a, rot16)
+#define ROT63(a) _mm_xor_si128 (_mm_srli_epi64 (a, 63), _mm_add_epi64 (a, a))
+// Lambdas don't take on the target attribute, so the message words are gathered with a macro
+#define LOAD(x, y) _mm_set_epi64x (static_cast<int64_t> (m[s[y]]), static_cast<int64_t> (m[s[x]]))
+
+/** Each row is split over two registers, lanes 0-1 and 2-3. The diagonal step rotates rows b, c and d with alignr */
+NANO_TARGET ("sse4.1")
+void compress_sse41 (blake2b_state * state_a, uint8_t const * block_a)
+{
+	auto const rot24 (_mm_setr_epi8 (3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10));
+	auto const rot16 (_mm_setr_epi8 (2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9));
+	uint64_t m[16];
+	std::memcpy (m, block_a, sizeof (m));
+	auto h (reinterpret_cast<__m128i *> (state_a->h));
+	auto a0 (_mm_loadu_si128 (h)), a1 (_mm_loadu_si128 (h + 1));
+	auto b0 (_mm_loadu_si128 (h + 2)), b1 (_mm_loadu_si128 (h + 3));
+	auto c0 (_mm_loadu_si128 (reinterpret_cast<__m128i const *> (blake2b_iv)));
+	auto c1 (_mm_loadu_si128 (reinterpret_cast<__m128i const *> (blake2b_iv + 2)));
+	// t and f follow h, so the counter and finalisation flags are one load
+	auto d0 (_mm_xor_si128 (_mm_loadu_si128 (reinterpret_cast<__m128i const *> (blake2b_iv + 4)), _mm_loadu_si128 (reinterpret_cast<__m128i const *> (state_a->t))));
+	auto d1 (_mm_xor_si128 (_mm_loadu_si128 (reinterpret_cast<__m128i const *> (blake2b_iv + 6)), _mm_loadu_si128 (reinterpret_cast<__m128i const *> (state_a->f))));
+	for (auto r (0); r < 12; ++r)
+	{
+		auto const * s (blake2b_sigma[r]);
+		NANO_BLAKE2B_G (a0, b0, c0, d0, LOAD (0, 2), LOAD (1, 3))
+		NANO_BLAKE2B_G (a1, b1, c1, d1, LOAD (4, 6), LOAD (5, 7))
+		// Diagonalise: b by one lane, c by two, d by three
+		auto t0 (_mm_alignr_epi8 (b1, b0, 8));
+		b1 = _mm_alignr_epi8 (b0, b1, 8);
+		b0 = t0;
+		std::swap (c0, c1);
+		t0 = _mm_alignr_epi8 (d0, d1, 8);
+		d1 = _mm_alignr_epi8 (d1, d0, 8);
+		d0 = t0;
+		NANO_BLAKE2B_G (a0, b0, c0, d0, LOAD (8, 10), LOAD (9, 11))
+		NANO_BLAKE2B_G (a1, b1, c1, d1, LOAD (12, 14), LOAD (13, 15))
+		t0 = _mm_alignr_epi8 (b0, b1, 8);
+		b1 = _mm_alignr_epi8 (b1, b0, 8);
+		b0 = t0;
+		std::swap (c0, c1);
+		t0 = _mm_alignr_epi8 (d1, d0, 8);
+		d1 = _mm_alignr_epi8 (d0, d1, 8);
+		d0 = t0;
+	}
+	_mm_storeu_si128 (h, _mm_xor_si128 (_mm_loadu_si128 (h), _mm_xor_si128 (a0, c0)));
+	_mm_storeu_si128 (h + 1, _mm_xor_si128 (_mm_loadu_si128 (h + 1), _mm_xor_si128 (a1, c1)));
+	_mm_storeu_si128 (h + 2, _mm_xor_si128 (_mm_loadu_si128 (h + 2), _mm_xor_si128 (b0, d0)));
+	_mm_storeu_si128 (h + 3, _mm_xor_si128 (_mm_loadu_si128 (h + 3), _mm_xor_si128 (b1, d1)));
+}
+
+#undef ADD
+#undef XOR
+#undef ROT32
+#undef ROT24
+#undef ROT16
+#undef ROT63
+#undef LOAD
+
+#define ADD(a, b) _mm256_add_epi64 (a, b)
+#define XOR(a, b) _mm256_xor_si256 (a, b)
+#define ROT32(a) _mm256_shuffle_epi32 (a, _MM_SHUFFLE (2, 3, 0, 1))
+#define ROT24(a) _mm256_shuffle_epi8 (a, rot24)
+#define ROT16(a) _mm256_shuffle_epi8 (a, rot16)
+#define ROT63(a) _mm256_xor_si256 (_mm256_srli_epi64 (a, 63), _mm256_add_epi64 (a, a))
+#define LOAD(first) _mm256_set_epi64x (static_cast<int64_t> (m[s[first + 6]]), static_cast<int64_t> (m[s[first + 4]]), static_cast<int64_t> (m[s[first + 2]]), static_cast<int64_t> (m[s[first]]))
+#define NANO_ROT24_AVX2 _mm256_setr_epi8 (3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10, 3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10)
+#define NANO_ROT16_AVX2 _mm256_setr_epi8 (2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9, 2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9)
+
+/** A whole row per register, the diagonal step rotates rows b, c and d with permute4x64 */
+NANO_TARGET ("avx2")
+void compress_avx2 (blake2b_state * state_a, uint8_t const * block_a)
+{
+	auto const rot24 (NANO_ROT24_AVX2);
+	auto const rot16 (NANO_ROT16_AVX2);
+	uint64_t m[16];
+	std::memcpy (m, block_a, sizeof (m));
+	auto h (reinterpret_cast<__m256i *> (state_a->h));
+	auto a (_mm256_loadu_si256 (h));
+	auto b (_mm256_loadu_si256 (h + 1));
+	auto c (_mm256_loadu_si256 (reinterpret_cast<__m256i const *> (blake2b_iv)));
+	auto d (_mm256_xor_si256 (_mm256_loadu_si256 (reinterpret_cast<__m256i const *> (blake2b_iv + 4)), _mm256_loadu_si256 (reinterpret_cast<__m256i const *> (state_a->t))));
+	for (auto r (0); r < 12; ++r)
+	{
+		auto const * s (blake2b_sigma[r]);
+		NANO_BLAKE2B_G (a, b, c, d, LOAD (0), LOAD (1))
+		b = _mm256_permute4x64_epi64 (b, _MM_SHUFFLE (0, 3, 2, 1));
+		c = _mm256_permute4x64_epi64 (c, _MM_SHUFFLE (1, 0, 3, 2));
+		d = _mm256_permute4x64_epi64 (d, _MM_SHUFFLE (2, 1, 0, 3));
+		NANO_BLAKE2B_G (a, b, c, d, LOAD (8), LOAD (9))
+		b = _mm256_permute4x64_epi64 (b, _MM_SHUFFLE (2, 1, 0, 3));
+		c = _mm256_permute4x64_epi64 (c, _MM_SHUFFLE (1, 0, 3, 2));
+		d = _mm256_permute4x64_epi64 (d, _MM_SHUFFLE (0, 3, 2, 1));
+	}
+	_mm256_storeu_si256 (h, _mm256_xor_si256 (_mm256_loadu_si256 (h), _mm256_xor_si256 (a, c)));
+	_mm256_storeu_si256 (h + 1, _mm256_xor_si256 (_mm256_loadu_si256 (h + 1), _mm256_xor_si256 (b, d)));
+}
+
+/**
+ * 4 messages of the same length, one per lane. Every state word is a register as in the work kernels, so the rounds are the
+ * scalar ones with lanes instead of words. Messages are copied a block at a time into a buffer so the last can be padded.
+ */
+NANO_TARGET ("avx2")
+void many_avx2 (uint8_t * const * out_a, size_t outlen_a, uint8_t const * const * in_a, size_t inlen_a)
+{
+	auto const rot24 (NANO_ROT24_AVX2);
+	auto const rot16 (NANO_ROT16_AVX2);
+	__m256i h[8];
+	for (auto i (0); i < 8; ++i)
+	{
+		h[i] = _mm256_set1_epi64x (static_cast<int64_t> (blake2b_iv[i] ^ (i == 0 ? 0x01010000 ^ outlen_a : 0)));
+	}
+	auto blocks (std::max<size_t> ((inlen_a + BLAKE2B_BLOCKBYTES - 1) / BLAKE2B_BLOCKBYTES, 1));
+	for (size_t block (0); block < blocks; ++block)
+	{
+		auto offset (block * BLAKE2B_BLOCKBYTES);
+		auto length (std::min<size_t> (inlen_a - offset, BLAKE2B_BLOCKBYTES));
+		auto last (block + 1 == blocks);
+		uint64_t words[4][16] = {};
+		// An empty message is a single block of padding, in_a may be null then
+		if (length != 0)
+		{
+			for (auto lane (0); lane < 4; ++lane)
+			{
+				std::memcpy (words[lane], in_a[lane] + offset, length);
+			}
+		}
+		__m256i m[16];
+		for (auto i (0); i < 16; ++i)
+		{
+			m[i] = _mm256_set_epi64x (static_cast<int64_t> (words[3][i]), static_cast<int64_t> (words[2][i]), static_cast<int64_t> (words[1][i]), static_cast<int64_t> (words[0][i]));
+		}
+		__m256i v[16];
+		for (auto i (0); i < 8; ++i)
+		{
+			v[i] = h[i];
+			v[i + 8] = _mm256_set1_epi64x (static_cast<int64_t> (blake2b_iv[i]));
+		}
+		v[12] = _mm256_xor_si256 (v[12], _mm256_set1_epi64x (static_cast<int64_t> (offset + length)));
+		if (last)
+		{
+			v[14] = _mm256_xor_si256 (v[14], _mm256_set1_epi64x (-1));
+		}
+		for (auto r (0); r < 12; ++r)
+		{
+			auto const * s (blake2b_sigma[r]);
+			NANO_BLAKE2B_G (v[0], v[4], v[8], v[12], m[s[0]], m[s[1]])
+			NANO_BLAKE2B_G (v[1], v[5], v[9], v[13], m[s[2]], m[s[3]])
+			NANO_BLAKE2B_G (v[2], v[6], v[10], v[14], m[s[4]], m[s[5]])
+			NANO_BLAKE2B_G (v[3], v[7], v[11], v[15], m[s[6]], m[s[7]])
+			NANO_BLAKE2B_G (v[0], v[5], v[10], v[15], m[s[8]], m[s[9]])
+			NANO_BLAKE2B_G (v[1], v[6], v[11], v[12], m[s[10]], m[s[11]])
+			NANO_BLAKE2B_G (v[2], v[7], v[8], v[13], m[s[12]], m[s[13]])
+			NANO_BLAKE2B_G (v[3], v[4], v[9], v[14], m[s[14]], m[s[15]])
+		}
+		for (auto i (0); i < 8; ++i)
+		{
+			h[i] = _mm256_xor_si256 (h[i], _mm256_xor_si256 (v[i], v[i + 8]));
+		}
+	}
+	uint64_t digests[8][4];
+	for (auto i (0); i < 8; ++i)
+	{
+		_mm256_storeu_si256 (reinterpret_cast<__m256i *> (digests[i]), h[i]);
+	}
+	for (auto lane (0); lane < 4; ++lane)
+	{
+		uint64_t digest[8];
+		for (auto i (0); i < 8; ++i)
+		{
+			digest[i] = digests[i][lane];
+		}
+		std::memcpy (out_a[lane], digest, outlen_a);
+	}
+}
+
+#undef ADD
+#undef XOR
+#undef ROT32
+#undef ROT24
+#undef ROT16
+#undef ROT63
+#undef LOAD
+#undef NANO_ROT24_AVX2
+#undef NANO_ROT16_AVX2
+#undef NANO_BLAKE2B_G
+#endif
+
+compress_function kernel_function (nano::blake2b_kernel kernel_a)
+{
+	switch (kernel_a)
+	{
+#if defined(NANO_SSE2)
+		case nano::blake2b_kernel::avx2:
+			return compress_avx2;
+		case nano::blake2b_kernel::sse41:
+			return compress_sse41;
+#endif
+		default:
+			return blake2b_compress_ref;
+	}
+}
+
+bool supported (nano::blake2b_kernel kernel_a)
+{
+#if defined(NANO_SSE2)
+	switch (kernel_a)
+	{
+		case nano::blake2b_kernel::avx2:
+			return nano::cpu ().avx2;
+		case nano::blake2b_kernel::sse41:
+			return nano::cpu ().sse41;
+		default:
+			return true;
+	}
+#else
+	return kernel_a == nano::blake2b_kernel::scalar;
+#endif
+}
+
+void resolve (blake2b_state * state_a, uint8_t const * block_a);
+
+// Constant initialised so hashing during static initialisation still works, the first compression picks the kernel
+std::atomic<compress_function> compress (resolve);
+std::atomic<nano::blake2b_kernel> selected (nano::blake2b_kernel::scalar);
+
+void resolve (blake2b_state * state_a, uint8_t const * block_a)
+{
+	nano::blake2b_select (nano::best_blake2b_kernel ());
+	compress.load (std::memory_order_relaxed) (state_a, block_a);
+}
+}
+
+void blake2b_compress (blake2b_state * S, uint8_t const block[BLAKE2B_BLOCKBYTES])
+{
+	compress.load (std::memory_order_relaxed) (S, block);
+}
+
+nano::blake2b_kernel nano::best_blake2b_kernel ()
+{
+	return supported (nano::blake2b_kernel::avx2) ? nano::blake2b_kernel::avx2 : supported (nano::blake2b_kernel::sse41) ? nano::blake2b_kernel::sse41 : nano::blake2b_kernel::scalar;
+}
+
+nano::blake2b_kernel nano::blake2b_selected ()
+{
+	// Resolves the kernel if nothing has been hashed yet
+	if (compress.load (std::memory_order_relaxed) == resolve)
+	{
+		nano::blake2b_select (nano::best_blake2b_kernel ());
+	}
+	return selected;
+}
+
+bool nano::blake2b_select (nano::blake2b_kernel kernel_a)
+{
+	auto error (!supported (kernel_a));
+	if (!error)
+	{
+		selected = kernel_a;
+		compress = kernel_function (kernel_a);
+	}
+	return error;
+}
+
+void nano::blake2b_many (uint8_t * const * out_a, size_t outlen_a, uint8_t const * const * in_a, size_t inlen_a, size_t count_a)
+{
+	size_t i (0);
+#if defined(NANO_SSE2)
+	if (nano::blake2b_selected () == nano::blake2b_kernel::avx2)
+	{
+		for (; i + 4 <= count_a; i += 4)
+		{
+			many_avx2 (out_a + i, outlen_a, in_a + i, inlen_a);
+		}
+	}
+#endif
+	for (; i < count_a; ++i)
+	{
+		blake2b (out_a[i], outlen_a, in_a[i], inlen_a, nullptr, 0);
+	}
+}
@@ -1,6 +1,11 @@
 // Copyright 2020 Wesley Shillingford. All rights reserved.
 #include <nano/blocks.h>
 
+#ifdef _WIN32
+#pragma warning (disable : 4804 ) /* '/': unsafe use of type 'bool' in operation warnings */
+#endif
+#include <blake2/blake2.h>
+
 nano::state_hashables::state_hashables (nano::account const & account_a, nano::block_hash const & previous_a, nano::account const & representative_a, nano::amount const & balance_a, nano::uint256_union const & link_a) :
 account (account_a),
 previous (previous_a),
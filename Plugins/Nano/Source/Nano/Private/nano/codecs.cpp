@@ -0,0 +1,313 @@
+// Copyright 2020 Wesley Shillingford. All rights reserved.
+#include <nano/codecs.h>
+#include <nano/cpu.h>
+
+#include <array>
+#include <cstring>
+
+#if defined(NANO_SSE2)
+#include <immintrin.h>
+#endif
+
+namespace
+{
+char const * hex_lookup ("0123456789ABCDEF");
+
+uint8_t hex_value (char value)
+{
+	if (value >= '0' && value <= '9')
+	{
+		return static_cast<uint8_t> (value - '0');
+	}
+	if (value >= 'a' && value <= 'f')
+	{
+		return static_cast<uint8_t> (value - 'a' + 10);
+	}
+	if (value >= 'A' && value <= 'F')
+	{
+		return static_cast<uint8_t> (value - 'A' + 10);
+	}
+	return 0xff;
+}
+
+void encode_hex_scalar (uint8_t const * bytes_a, size_t size_a, char * text_a)
+{
+	for (size_t i (0); i < size_a; ++i)
+	{
+		text_a[i * 2] = hex_lookup[bytes_a[i] >> 4];
+		text_a[i * 2 + 1] = hex_lookup[bytes_a[i] & 0xf];
+	}
+}
+
+/** Decodes pairs of characters, length_a is even */
+bool decode_hex_scalar (char const * text_a, size_t length_a, uint8_t * bytes_a)
+{
+	uint8_t invalid (0);
+	for (size_t i (0); i < length_a; i += 2)
+	{
+		auto high (hex_value (text_a[i]));
+		auto low (hex_value (text_a[i + 1]));
+		invalid |= static_cast<uint8_t> (high | low) & 0xf0;
+		bytes_a[i / 2] = static_cast<uint8_t> ((high << 4) | (low & 0xf));
+	}
+	return invalid != 0;
+}
+
+#if defined(NANO_SSE2)
+/** Nibbles (0-15) in each byte to ascii */
+__m128i nibbles_to_ascii (__m128i nibbles_a)
+{
+	auto letters (_mm_cmpgt_epi8 (nibbles_a, _mm_set1_epi8 (9)));
+	auto offset (_mm_add_epi8 (_mm_set1_epi8 ('0'), _mm_and_si128 (letters, _mm_set1_epi8 ('A' - '0' - 10))));
+	return _mm_add_epi8 (nibbles_a, offset);
+}
+
+/** 16 bytes to 32 characters */
+void encode_hex_sse2 (uint8_t const * bytes_a, char * text_a)
+{
+	auto value (_mm_loadu_si128 (reinterpret_cast<__m128i const *> (bytes_a)));
+	auto mask (_mm_set1_epi8 (0x0f));
+	auto high (_mm_and_si128 (_mm_srli_epi16 (value, 4), mask));
+	auto low (_mm_and_si128 (value, mask));
+	_mm_storeu_si128 (reinterpret_cast<__m128i *> (text_a), nibbles_to_ascii (_mm_unpacklo_epi8 (high, low)));
+	_mm_storeu_si128 (reinterpret_cast<__m128i *> (text_a + 16), nibbles_to_ascii (_mm_unpackhi_epi8 (high, low)));
+}
+
+/** 16 characters to 8 bytes, returns true on invalid characters */
+bool decode_hex_sse2 (char const * text_a, uint8_t * bytes_a)
+{
+	auto text (_mm_loadu_si128 (reinterpret_cast<__m128i const *> (text_a)));
+	auto zero (_mm_setzero_si128 ());
+	auto digits (_mm_sub_epi8 (text, _mm_set1_epi8 ('0')));
+	auto is_digit (_mm_cmpeq_epi8 (_mm_subs_epu8 (digits, _mm_set1_epi8 (9)), zero));
+	auto letters (_mm_sub_epi8 (_mm_or_si128 (text, _mm_set1_epi8 (0x20)), _mm_set1_epi8 ('a')));
+	auto is_letter (_mm_cmpeq_epi8 (_mm_subs_epu8 (letters, _mm_set1_epi8 (5)), zero));
+	auto error (_mm_movemask_epi8 (_mm_or_si128 (is_digit, is_letter)) != 0xffff);
+	auto nibbles (_mm_or_si128 (_mm_and_si128 (is_digit, digits), _mm_andnot_si128 (is_digit, _mm_add_epi8 (letters, _mm_set1_epi8 (10)))));
+	// Each 16-bit lane holds the high nibble in its low byte and the low nibble in its high byte
+	auto high (_mm_and_si128 (nibbles, _mm_set1_epi16 (0x00ff)));
+	auto low (_mm_srli_epi16 (nibbles, 8));
+	auto combined (_mm_or_si128 (_mm_slli_epi16 (high, 4), low));
+	_mm_storel_epi64 (reinterpret_cast<__m128i *> (bytes_a), _mm_packus_epi16 (combined, combined));
+	return error;
+}
+
+NANO_TARGET ("avx2")
+__m256i nibbles_to_ascii_avx2 (__m256i nibbles_a)
+{
+	auto letters (_mm256_cmpgt_epi8 (nibbles_a, _mm256_set1_epi8 (9)));
+	auto offset (_mm256_add_epi8 (_mm256_set1_epi8 ('0'), _mm256_and_si256 (letters, _mm256_set1_epi8 ('A' - '0' - 10))));
+	return _mm256_add_epi8 (nibbles_a, offset);
+}
+
+/** 32 bytes to 64 characters */
+NANO_TARGET ("avx2")
+void encode_hex_avx2 (uint8_t const * bytes_a, char * text_a)
+{
+	auto value (_mm256_loadu_si256 (reinterpret_cast<__m256i const *> (bytes_a)));
+	auto mask (_mm256_set1_epi8 (0x0f));
+	auto high (_mm256_and_si256 (_mm256_srli_epi16 (value, 4), mask));
+	auto low (_mm256_and_si256 (value, mask));
+	auto first (_mm256_unpacklo_epi8 (high, low));
+	auto second (_mm256_unpackhi_epi8 (high, low));
+	// Unpacking works within 128-bit lanes so put the halves back in order
+	_mm256_storeu_si256 (reinterpret_cast<__m256i *> (text_a), nibbles_to_ascii_avx2 (_mm256_permute2x128_si256 (first, second, 0x20)));
+	_mm256_storeu_si256 (reinterpret_cast<__m256i *> (text_a + 32), nibbles_to_ascii_avx2 (_mm256_permute2x128_si256 (first, second, 0x31)));
+}
+
+/** 32 characters to 16 bytes, returns true on invalid characters */
+NANO_TARGET ("avx2")
+bool decode_hex_avx2 (char const * text_a, uint8_t * bytes_a)
+{
+	auto text (_mm256_loadu_si256 (reinterpret_cast<__m256i const *> (text_a)));
+	auto zero (_mm256_setzero_si256 ());
+	auto digits (_mm256_sub_epi8 (text, _mm256_set1_epi8 ('0')));
+	auto is_digit (_mm256_cmpeq_epi8 (_mm256_subs_epu8 (digits, _mm256_set1_epi8 (9)), zero));
+	auto letters (_mm256_sub_epi8 (_mm256_or_si256 (text, _mm256_set1_epi8 (0x20)), _mm256_set1_epi8 ('a')));
+	auto is_letter (_mm256_cmpeq_epi8 (_mm256_subs_epu8 (letters, _mm256_set1_epi8 (5)), zero));
+	auto error (static_cast<uint32_t> (_mm256_movemask_epi8 (_mm256_or_si256 (is_digit, is_letter))) != 0xffffffff);
+	auto nibbles (_mm256_blendv_epi8 (_mm256_add_epi8 (letters, _mm256_set1_epi8 (10)), digits, is_digit));
+	auto high (_mm256_and_si256 (nibbles, _mm256_set1_epi16 (0x00ff)));
+	auto low (_mm256_srli_epi16 (nibbles, 8));
+	auto combined (_mm256_or_si256 (_mm256_slli_epi16 (high, 4), low));
+	// Packing is also per 128-bit lane, the wanted bytes end up in qwords 0 and 2
+	auto packed (_mm256_permute4x64_epi64 (_mm256_packus_epi16 (combined, combined), 0xd8));
+	_mm_storeu_si128 (reinterpret_cast<__m128i *> (bytes_a), _mm256_castsi256_si128 (packed));
+	return error;
+}
+#endif
+
+uint64_t load_le64 (char const * source_a)
+{
+	uint64_t result (0);
+	for (auto i (7); i >= 0; --i)
+	{
+		result = (result << 8) | static_cast<uint8_t> (source_a[i]);
+	}
+	return result;
+}
+
+void store_le64 (char * destination_a, uint64_t value_a)
+{
+	for (auto i (0); i < 8; ++i)
+	{
+		destination_a[i] = static_cast<char> (value_a);
+		value_a >>= 8;
+	}
+}
+
+/** True if all 8 bytes are '0' to '9' */
+bool is_eight_digits (uint64_t chars_a)
+{
+	return ((chars_a & 0xf0f0f0f0f0f0f0f0) | (((chars_a + 0x0606060606060606) & 0xf0f0f0f0f0f0f0f0) >> 4)) == 0x3333333333333333;
+}
+
+/** 8 ascii digits (first digit in the lowest byte) to their value by pairing up neighbours in 3 multiplies */
+uint32_t parse_eight_digits (uint64_t chars_a)
+{
+	chars_a = ((chars_a & 0x0f0f0f0f0f0f0f0f) * 2561) >> 8;
+	chars_a = ((chars_a & 0x00ff00ff00ff00ff) * 6553601) >> 16;
+	return static_cast<uint32_t> (((chars_a & 0x0000ffff0000ffff) * 42949672960001) >> 32);
+}
+
+/** value_a < 10^8 to 8 ascii digits (first digit in the lowest byte) */
+uint64_t format_eight_digits (uint32_t value_a)
+{
+	// Split into two 4 digit halves, then each half into hundreds, then tens, all in parallel lanes
+	uint64_t merged ((value_a / 10000) | (static_cast<uint64_t> (value_a % 10000) << 32));
+	uint64_t hundreds (((merged * 10486) >> 20) & 0x0000007f0000007f);
+	uint64_t pairs (((merged - 100 * hundreds) << 16) + hundreds);
+	uint64_t tens (((pairs * 103) >> 10) & 0x000f000f000f000f);
+	uint64_t digits (tens + ((pairs - 10 * tens) << 8));
+	return digits | 0x3030303030303030;
+}
+}
+
+void nano::codec::encode_hex (uint8_t const * bytes_a, size_t size_a, char * text_a)
+{
+	size_t i (0);
+#if defined(NANO_SSE2)
+	if (nano::cpu ().avx2)
+	{
+		for (; i + 32 <= size_a; i += 32)
+		{
+			encode_hex_avx2 (bytes_a + i, text_a + i * 2);
+		}
+	}
+	for (; i + 16 <= size_a; i += 16)
+	{
+		encode_hex_sse2 (bytes_a + i, text_a + i * 2);
+	}
+#endif
+	encode_hex_scalar (bytes_a + i, size_a - i, text_a + i * 2);
+}
+
+bool nano::codec::decode_hex (char const * text_a, size_t length_a, uint8_t * bytes_a, size_t size_a)
+{
+	auto error (length_a == 0 || length_a > size_a * 2);
+	if (!error)
+	{
+		std::array<uint8_t, 64> result{};
+		check (size_a <= result.size ());
+		size_t i (0);
+		auto output (result.data () + size_a - (length_a + 1) / 2);
+		if (length_a % 2 != 0)
+		{
+			// Odd lengths start with a lone low nibble
+			auto low (hex_value (*text_a));
+			error = low > 0xf;
+			*output++ = static_cast<uint8_t> (low & 0xf);
+			++i;
+		}
+#if defined(NANO_SSE2)
+		if (nano::cpu ().avx2)
+		{
+			for (; !error && i + 32 <= length_a; i += 32, output += 16)
+			{
+				error = decode_hex_avx2 (text_a + i, output);
+			}
+		}
+		for (; !error && i + 16 <= length_a; i += 16, output += 8)
+		{
+			error = decode_hex_sse2 (text_a + i, output);
+		}
+#endif
+		error = error || decode_hex_scalar (text_a + i, length_a - i, output);
+		if (!error)
+		{
+			std::memcpy (bytes_a, result.data (), size_a);
+		}
+	}
+	return error;
+}
+
+template <size_t bits_a>
+size_t nano::codec::encode_dec (nano::fixed_uint<bits_a> const & number_a, char * text_a)
+{
+	// Peel off 8 digit chunks from the bottom into a buffer rounded up to whole chunks
+	constexpr auto chunks ((dec_digits (bits_a) + 7) / 8);
+	char buffer[chunks * 8];
+	auto position (buffer + sizeof (buffer));
+	auto number_l (number_a);
+	do
+	{
+		position -= 8;
+		store_le64 (position, format_eight_digits (number_l.divide (100000000)));
+	} while (!number_l.is_zero ());
+	auto end (buffer + sizeof (buffer));
+	while (position + 1 < end && *position == '0')
+	{
+		++position;
+	}
+	auto length (static_cast<size_t> (end - position));
+	std::memcpy (text_a, position, length);
+	return length;
+}
+
+template <size_t bits_a>
+bool nano::codec::decode_dec (char const * text_a, size_t length_a, nano::fixed_uint<bits_a> & number_a)
+{
+	auto error (length_a == 0);
+	if (!error)
+	{
+		nano::fixed_uint<bits_a> number_l;
+		uint64_t overflow (0);
+		// Leading digits which don't fill a whole chunk
+		auto head (length_a % 8);
+		uint64_t value (0);
+		for (size_t i (0); i < head; ++i)
+		{
+			auto digit (static_cast<uint8_t> (text_a[i] - '0'));
+			error = error || digit > 9;
+			value = value * 10 + digit;
+		}
+		number_l.limbs[0] = value;
+		size_t i (head);
+		for (; !error && i + 16 <= length_a; i += 16)
+		{
+			auto first (load_le64 (text_a + i));
+			auto second (load_le64 (text_a + i + 8));
+			error = !is_eight_digits (first) || !is_eight_digits (second);
+			overflow |= number_l.multiply_add (10000000000000000, static_cast<uint64_t> (parse_eight_digits (first)) * 100000000 + parse_eight_digits (second));
+		}
+		if (!error && i < length_a)
+		{
+			auto chars (load_le64 (text_a + i));
+			error = !is_eight_digits (chars);
+			overflow |= number_l.multiply_add (100000000, parse_eight_digits (chars));
+		}
+		error = error || overflow != 0;
+		if (!error)
+		{
+			number_a = number_l;
+		}
+	}
+	return error;
+}
+
+template size_t nano::codec::encode_dec<128> (nano::uint128_t const &, char *);
+template size_t nano::codec::encode_dec<256> (nano::uint256_t const &, char *);
+template size_t nano::codec::encode_dec<512> (nano::uint512_t const &, char *);
+template bool nano::codec::decode_dec<128> (char const *, size_t, nano::uint128_t &);
+template bool nano::codec::decode_dec<256> (char const *, size_t, nano::uint256_t &);
+template bool nano::codec::decode_dec<512> (char const *, size_t, nano::uint512_t &);
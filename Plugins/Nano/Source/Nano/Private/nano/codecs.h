@@ -0,0 +1,46 @@
+// Copyright 2020 Wesley Shillingford. All rights reserved.
+#pragma once
+
+#include <nano/numbers.h>
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * Allocation free text codecs for the number unions. Everything writes into caller provided buffers, no null terminator is added.
+ * Hex uses SSE2 (and AVX2 when the cpu has it) on x86, decimal parsing consumes 8 digits per step with SWAR arithmetic.
+ */
+namespace nano
+{
+namespace codec
+{
+	/** Most decimal digits a bits_a wide number can need, 39 for 128 bits */
+	constexpr size_t dec_digits (size_t bits_a)
+	{
+		return bits_a == 128 ? 39 : bits_a == 256 ? 78 : bits_a == 512 ? 155 : (bits_a * 30103) / 100000 + 1;
+	}
+
+	/** Writes size_a * 2 upper case hex characters */
+	void encode_hex (uint8_t const * bytes_a, size_t size_a, char * text_a);
+
+	/**
+	 * Decodes length_a hex characters of either case into size_a big-endian bytes, shorter input is right aligned and zero extended. size_a is at most 64
+	 * @return true if the input is empty, too long or contains anything other than hex digits. bytes_a is untouched on error
+	 */
+	bool decode_hex (char const * text_a, size_t length_a, uint8_t * bytes_a, size_t size_a);
+
+	/**
+	 * Writes the decimal digits of number_a without leading zeroes, text_a must have room for dec_digits (bits_a) characters
+	 * @return Number of characters written
+	 */
+	template <size_t bits_a>
+	size_t encode_dec (nano::fixed_uint<bits_a> const & number_a, char * text_a);
+
+	/**
+	 * Parses length_a decimal digits, leading zeroes are accepted
+	 * @return true if the input is empty, contains anything other than digits or overflows. number_a is untouched on error
+	 */
+	template <size_t bits_a>
+	bool decode_dec (char const * text_a, size_t length_a, nano::fixed_uint<bits_a> & number_a);
+}
+}
@@ -0,0 +1,75 @@
+// Copyright 2020 Wesley Shillingford. All rights reserved.
+#include <nano/cpu.h>
+
+#include <cstdint>
+
+#if defined(NANO_X86)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace
+{
+#if defined(NANO_X86)
+void cpuid (uint32_t leaf_a, uint32_t subleaf_a, uint32_t (&registers_a)[4])
+{
+#if defined(_MSC_VER)
+	int registers_l[4];
+	__cpuidex (registers_l, static_cast<int> (leaf_a), static_cast<int> (subleaf_a));
+	for (auto i (0); i < 4; ++i)
+	{
+		registers_a[i] = static_cast<uint32_t> (registers_l[i]);
+	}
+#else
+	__cpuid_count (leaf_a, subleaf_a, registers_a[0], registers_a[1], registers_a[2], registers_a[3]);
+#endif
+}
+
+uint64_t xgetbv ()
+{
+#if defined(_MSC_VER)
+	return _xgetbv (0);
+#else
+	uint32_t eax, edx;
+	__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+	return (static_cast<uint64_t> (edx) << 32) | eax;
+#endif
+}
+#endif
+
+nano::cpu_features detect ()
+{
+	nano::cpu_features result;
+#if defined(NANO_X86)
+	uint32_t registers[4];
+	cpuid (0, 0, registers);
+	auto max_leaf (registers[0]);
+	if (max_leaf >= 1)
+	{
+		cpuid (1, 0, registers);
+		result.sse2 = (registers[3] & (1u << 26)) != 0;
+		result.ssse3 = (registers[2] & (1u << 9)) != 0;
+		result.sse41 = (registers[2] & (1u << 19)) != 0;
+		auto osxsave ((registers[2] & (1u << 27)) != 0);
+		auto avx ((registers[2] & (1u << 28)) != 0);
+		// The OS has to save the YMM registers on context switches as well
+		auto ymm_enabled (osxsave && avx && (xgetbv () & 0x6) == 0x6);
+		if (ymm_enabled && max_leaf >= 7)
+		{
+			cpuid (7, 0, registers);
+			result.avx2 = (registers[1] & (1u << 5)) != 0;
+		}
+	}
+#endif
+	return result;
+}
+}
+
+nano::cpu_features const & nano::cpu ()
+{
+	static nano::cpu_features const features (detect ());
+	return features;
+}
@@ -0,0 +1,33 @@
+// Copyright 2020 Wesley Shillingford. All rights reserved.
+#pragma once
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+#define NANO_X86 1
+#endif
+
+#if defined(NANO_X86) && (defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define NANO_SSE2 1
+#endif
+
+// MSVC accepts any intrinsic without a flag, gcc/clang need the target enabled per function
+#if defined(__GNUC__) || defined(__clang__)
+#define NANO_TARGET(target_a) __attribute__ ((target (target_a)))
+#else
+#define NANO_TARGET(target_a)
+#endif
+
+namespace nano
+{
+/** Instruction set extensions usable on this machine, which also takes OS support for the wider registers into account */
+class cpu_features final
+{
+public:
+	bool sse2{ false };
+	bool ssse3{ false };
+	bool sse41{ false };
+	bool avx2{ false };
+};
+
+/** Detected once on first use */
+nano::cpu_features const & cpu ();
+}
@@ -0,0 +1,147 @@
+// Copyright 2020 Wesley Shillingford. All rights reserved.
+#include <nano/cpu.h>
+#include <nano/ed25519_backends.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+
+extern "C" {
+#include <ed25519-donna/ed25519.h>
+
+#if defined(NANO_SSE2)
+void ed25519_publickey_sse2 (ed25519_secret_key const sk, ed25519_public_key pk);
+void ed25519_sign_sse2 (unsigned char const * m, size_t mlen, ed25519_secret_key const sk, ed25519_public_key const pk, ed25519_signature RS);
+int ed25519_sign_open_sse2 (unsigned char const * m, size_t mlen, ed25519_public_key const pk, ed25519_signature const RS);
+int ed25519_sign_open_batch_sse2 (unsigned char const ** m, size_t * mlen, unsigned char const ** pk, unsigned char const ** RS, size_t num, int * valid);
+#endif
+
+void ed25519_publickey_32bit (ed25519_secret_key const sk, ed25519_public_key pk);
+void ed25519_sign_32bit (unsigned char const * m, size_t mlen, ed25519_secret_key const sk, ed25519_public_key const pk, ed25519_signature RS);
+int ed25519_sign_open_32bit (unsigned char const * m, size_t mlen, ed25519_public_key const pk, ed25519_signature const RS);
+int ed25519_sign_open_batch_32bit (unsigned char const ** m, size_t * mlen, unsigned char const ** pk, unsigned char const ** RS, size_t num, int * valid);
+}
+
+namespace
+{
+nano::ed25519_functions const functions[nano::ed25519_backend_count] = {
+	{ ed25519_publickey, ed25519_sign, ed25519_sign_open, ed25519_sign_open_batch },
+#if defined(NANO_SSE2)
+	{ ed25519_publickey_sse2, ed25519_sign_sse2, ed25519_sign_open_sse2, ed25519_sign_open_batch_sse2 },
+#else
+	{ nullptr, nullptr, nullptr, nullptr },
+#endif
+	{ ed25519_publickey_32bit, ed25519_sign_32bit, ed25519_sign_open_32bit, ed25519_sign_open_batch_32bit }
+};
+
+char const * const names[nano::ed25519_backend_count] = { "donna64", "sse2", "donna32" };
+
+nano::ed25519_backend default_backend ()
+{
+	if (sizeof (void *) == 8)
+	{
+		return nano::ed25519_backend::donna64;
+	}
+	return nano::ed25519_supported (nano::ed25519_backend::sse2) ? nano::ed25519_backend::sse2 : nano::ed25519_backend::donna32;
+}
+
+std::atomic<nano::ed25519_backend> & selected ()
+{
+	static std::atomic<nano::ed25519_backend> selected_l (default_backend ());
+	return selected_l;
+}
+
+/** Signs and verifies a few messages, signing dominates what the plugin does so both are weighed equally */
+double signatures_per_second (nano::ed25519_functions const & functions_a)
+{
+	auto constexpr count (64);
+	unsigned char sk[32];
+	unsigned char pk[32];
+	unsigned char message[32];
+	unsigned char signature[64];
+	std::memset (sk, 0x5a, sizeof (sk));
+	std::memset (message, 0, sizeof (message));
+	functions_a.publickey (sk, pk);
+	auto start (std::chrono::steady_clock::now ());
+	for (auto i (0); i < count; ++i)
+	{
+		message[0] = static_cast<unsigned char> (i);
+		functions_a.sign (message, sizeof (message), sk, pk, signature);
+		functions_a.sign_open (message, sizeof (message), pk, signature);
+	}
+	std::chrono::duration<double> elapsed (std::chrono::steady_clock::now () - start);
+	return count / elapsed.count ();
+}
+}
+
+bool nano::ed25519_supported (nano::ed25519_backend backend_a)
+{
+	auto index (static_cast<size_t> (backend_a));
+	auto supported (index < nano::ed25519_backend_count && functions[index].sign != nullptr);
+	if (backend_a == nano::ed25519_backend::sse2)
+	{
+		supported = supported && nano::cpu ().sse2;
+	}
+	return supported;
+}
+
+char const * nano::ed25519_backend_name (nano::ed25519_backend backend_a)
+{
+	return names[static_cast<size_t> (backend_a)];
+}
+
+bool nano::ed25519_backend_from_name (char const * name_a, nano::ed25519_backend & backend_a)
+{
+	for (size_t i (0); i < nano::ed25519_backend_count; ++i)
+	{
+		auto backend (static_cast<nano::ed25519_backend> (i));
+		if (std::strcmp (name_a, names[i]) == 0 && nano::ed25519_supported (backend))
+		{
+			backend_a = backend;
+			return false;
+		}
+	}
+	return true;
+}
+
+nano::ed25519_functions const & nano::ed25519 ()
+{
+	return functions[static_cast<size_t> (selected ().load (std::memory_order_relaxed))];
+}
+
+nano::ed25519_backend nano::ed25519_selected ()
+{
+	return selected ();
+}
+
+bool nano::ed25519_select (nano::ed25519_backend backend_a)
+{
+	auto error (!nano::ed25519_supported (backend_a));
+	if (!error)
+	{
+		selected () = backend_a;
+	}
+	return error;
+}
+
+std::array<double, nano::ed25519_backend_count> nano::ed25519_select_fastest ()
+{
+	std::array<double, nano::ed25519_backend_count> rates{};
+	auto fastest (nano::ed25519_selected ());
+	for (size_t i (0); i < nano::ed25519_backend_count; ++i)
+	{
+		auto backend (static_cast<nano::ed25519_backend> (i));
+		if (nano::ed25519_supported (backend))
+		{
+			// Once untimed so the tables are in cache
+			signatures_per_second (functions[i]);
+			rates[i] = signatures_per_second (functions[i]);
+			if (rates[i] > rates[static_cast<size_t> (fastest)])
+			{
+				fastest = backend;
+			}
+		}
+	}
+	nano::ed25519_select (fastest);
+	return rates;
+}
@@ -3,31 +3,41 @@
 #pragma warning (disable : 4804 ) /* '/': unsafe use of type 'bool' in operation warnings */
 #endif
 #include <blake2/blake2.h>
-#include <duthomhas/csprng.hpp>
+#include <nano/random_pool.h>
 #include <array>
 
 extern "C" {
 #include <ed25519-donna/ed25519-hash-custom.h>
+}
+
+namespace
+{
+static_assert (sizeof (ed25519_hash_context::blake2) >= sizeof (blake2b_state), "ed25519_hash_context too small for blake2b_state");
+
+blake2b_state * blake2_state (ed25519_hash_context * ctx)
+{
+	return reinterpret_cast<blake2b_state *> (ctx->blake2);
+}
+}
+
+extern "C" {
 void ed25519_randombytes_unsafe (void * out, size_t outlen)
 {
-	duthomhas::csprng rng;
-	rng(out, outlen);
+	nano::random_pool::generate_block (static_cast<uint8_t *> (out), outlen);
 }
 void ed25519_hash_init (ed25519_hash_context * ctx)
 {
-	ctx->blake2 = new blake2b_state;
-	blake2b_init (reinterpret_cast<blake2b_state *> (ctx->blake2), 64);
+	blake2b_init (blake2_state (ctx), 64);
 }
 
 void ed25519_hash_update (ed25519_hash_context * ctx, uint8_t const * in, size_t inlen)
 {
-	blake2b_update (reinterpret_cast<blake2b_state *> (ctx->blake2), in, inlen);
+	blake2b_update (blake2_state (ctx), in, inlen);
 }
 
 void ed25519_hash_final (ed25519_hash_context * ctx, uint8_t * out)
 {
-	blake2b_final (reinterpret_cast<blake2b_state *> (ctx->blake2), out, 64);
-	delete reinterpret_cast<blake2b_state *> (ctx->blake2);
+	blake2b_final (blake2_state (ctx), out, 64);
 }
 
 void ed25519_hash (uint8_t * out, uint8_t const * in, size_t inlen)
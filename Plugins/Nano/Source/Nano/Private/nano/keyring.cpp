@@ -0,0 +1,97 @@
+// Copyright 2020 Wesley Shillingford. All rights reserved.
+#include <nano/ed25519_backends.h>
+#include <nano/keyring.h>
+
+namespace
+{
+uint32_t const index_bits (24);
+uint32_t const index_mask ((1u << index_bits) - 1);
+
+nano::keyring::handle make_handle (uint32_t index_a, uint8_t generation_a)
+{
+	return (static_cast<uint32_t> (generation_a) << index_bits) | index_a;
+}
+}
+
+constexpr nano::keyring::handle nano::keyring::invalid;
+
+nano::keyring::handle nano::keyring::insert (nano::raw_key const & prv_a)
+{
+	nano::public_key pub;
+	nano::ed25519 ().publickey (prv_a.data.bytes.data (), pub.bytes.data ());
+	auto existing (handles.find (pub));
+	if (existing != nullptr)
+	{
+		++slots[*existing & index_mask].references;
+		return *existing;
+	}
+
+	uint32_t index;
+	if (!free_slots.empty ())
+	{
+		index = free_slots.back ();
+		free_slots.pop_back ();
+	}
+	else
+	{
+		check (slots.size () < index_mask);
+		index = static_cast<uint32_t> (slots.size ());
+		slots.emplace_back ();
+	}
+	auto & slot_l (slots[index]);
+	slot_l.entry.prv = prv_a;
+	slot_l.entry.pub = pub;
+	pub.encode_account (slot_l.entry.account);
+	slot_l.references = 1;
+	auto result (make_handle (index, slot_l.generation));
+	handles.emplace (pub, result);
+	return result;
+}
+
+bool nano::keyring::acquire (handle handle_a)
+{
+	auto slot_l (resolve (handle_a));
+	if (slot_l != nullptr)
+	{
+		++slot_l->references;
+	}
+	return slot_l == nullptr;
+}
+
+bool nano::keyring::erase (handle handle_a)
+{
+	auto slot_l (resolve (handle_a));
+	if (slot_l != nullptr && --slot_l->references == 0)
+	{
+		handles.erase (slot_l->entry.pub);
+		slot_l->entry.prv.data.clear ();
+		// Generation 0 is skipped so a handle can never be 0
+		slot_l->generation = slot_l->generation == 255 ? 1 : slot_l->generation + 1;
+		free_slots.push_back (handle_a & index_mask);
+	}
+	return slot_l == nullptr;
+}
+
+nano::keyring::entry const * nano::keyring::find (handle handle_a) const
+{
+	auto slot_l (const_cast<nano::keyring *> (this)->resolve (handle_a));
+	return slot_l != nullptr ? &slot_l->entry : nullptr;
+}
+
+nano::keyring::handle nano::keyring::find (nano::public_key const & pub_a) const
+{
+	auto existing (handles.find (pub_a));
+	return existing != nullptr ? *existing : invalid;
+}
+
+size_t nano::keyring::size () const
+{
+	return slots.size () - free_slots.size ();
+}
+
+nano::keyring::slot * nano::keyring::resolve (handle handle_a)
+{
+	auto index (handle_a & index_mask);
+	auto valid (index < slots.size () && slots[index].references > 0 && slots[index].generation == handle_a >> index_bits);
+	return valid ? &slots[index] : nullptr;
+}
@@ -1,11 +1,14 @@
 // Copyright 2020 Wesley Shillingford. All rights reserved.
+#include <nano/blake2b.h>
+#include <nano/codecs.h>
+#include <nano/ed25519_backends.h>
 #include <nano/numbers.h>
 
-#include <baseconverter/base_converter.hpp>
-#include <ed25519-donna/ed25519.h>
 #ifdef _WIN32
 #pragma warning(disable : 4804) /* '/': unsafe use of type 'bool' in operation warnings */
 #endif
+#include <algorithm>
+#include <cstring>
 #include <iomanip>
 #include <sstream>
 
@@ -14,21 +17,106 @@
 namespace
 {
 char const * account_lookup ("13456789abcdefghijkmnopqrstuwxyz");
-char const * account_reverse ("~0~1234567~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~89:;<=>?@AB~CDEFGHIJK~LMNO~~~~~");
-char account_encode (uint8_t value)
+
+std::array<uint8_t, 256> make_account_reverse ()
 {
-	check (value < 32);
-	auto result (account_lookup[value]);
+	std::array<uint8_t, 256> result;
+	result.fill (0xff);
+	for (uint8_t i (0); i < 32; ++i)
+	{
+		result[static_cast<uint8_t> (account_lookup[i])] = i;
+	}
 	return result;
 }
-uint8_t account_decode (char value)
+
+/** Character to its 5 bit value, 0xff for anything outside the alphabet */
+std::array<uint8_t, 256> const account_reverse (make_account_reverse ());
+
+/*
+ * An account is the 32 byte key followed by a 5 byte checksum, 296 bits written as 60 characters of 5 bits each.
+ * Right aligned in 40 bytes it splits evenly into 8 groups of 5 bytes <-> 8 characters, the first 4 characters are always zero
+ */
+size_t const account_padding (4);
+using account_bytes = std::array<uint8_t, 40>;
+
+size_t const checksum_size (5);
+
+/** The checksum is blake2b-40 of the key, stored byte reversed */
+void account_checksum (uint8_t const * key_a, uint8_t * checksum_a)
+{
+	uint8_t hash[checksum_size];
+	blake2b (hash, sizeof (hash), key_a, 32, nullptr, 0);
+	std::reverse_copy (hash, hash + checksum_size, checksum_a);
+}
+
+/** hash_a is the blake2b-40 of the key, so a batch can hash all of its keys together */
+void encode_account_body (nano::uint256_union const & key_a, uint8_t const * hash_a, char * destination_a)
+{
+	account_bytes buffer{};
+	std::memcpy (buffer.data () + 3, key_a.bytes.data (), key_a.bytes.size ());
+	std::reverse_copy (hash_a, hash_a + checksum_size, buffer.data () + 35);
+	for (size_t group (0); group < 8; ++group)
+	{
+		auto source (buffer.data () + group * 5);
+		uint64_t value (0);
+		for (auto i (0); i < 5; ++i)
+		{
+			value = (value << 8) | source[i];
+		}
+		for (size_t character (group == 0 ? account_padding : 0); character < 8; ++character)
+		{
+			destination_a[group * 8 + character - account_padding] = account_lookup[(value >> (35 - character * 5)) & 0x1f];
+		}
+	}
+}
+
+/** Decodes the 60 characters after the prefix, true on error */
+bool decode_account_body (char const * source_a, nano::uint256_union & key_a)
+{
+	account_bytes buffer;
+	uint8_t invalid (0);
+	for (size_t group (0); group < 8; ++group)
+	{
+		uint64_t value (0);
+		for (size_t character (group == 0 ? account_padding : 0); character < 8; ++character)
+		{
+			auto digit (account_reverse[static_cast<uint8_t> (source_a[group * 8 + character - account_padding])]);
+			invalid |= digit;
+			value = (value << 5) | (digit & 0x1f);
+		}
+		for (auto i (0); i < 5; ++i)
+		{
+			buffer[group * 5 + i] = static_cast<uint8_t> (value >> (32 - i * 8));
+		}
+	}
+	auto error ((invalid & 0x80) != 0);
+	if (!error)
+	{
+		uint8_t checksum[5];
+		account_checksum (buffer.data () + 3, checksum);
+		error = std::memcmp (checksum, buffer.data () + 35, sizeof (checksum)) != 0;
+		if (!error)
+		{
+			std::memcpy (key_a.bytes.data (), buffer.data () + 3, key_a.bytes.size ());
+		}
+	}
+	return error;
+}
+template <size_t bits_a>
+void store_number (nano::fixed_uint<bits_a> const & number_a, uint8_t * bytes_a)
+{
+	for (size_t i (0); i < number_a.limb_count; ++i)
+	{
+		nano::detail::store_be64 (bytes_a + (number_a.limb_count - 1 - i) * 8, number_a.limbs[i]);
+	}
+}
+template <size_t bits_a>
+nano::fixed_uint<bits_a> load_number (uint8_t const * bytes_a)
 {
-	check (value >= '0');
-	check (value <= '~');
-	auto result (account_reverse[value - 0x30]);
-	if (result != '~')
+	nano::fixed_uint<bits_a> result;
+	for (size_t i (0); i < result.limb_count; ++i)
 	{
-		result -= 0x30;
+		result.limbs[i] = nano::detail::load_be64 (bytes_a + (result.limb_count - 1 - i) * 8);
 	}
 	return result;
 }
@@ -37,24 +125,17 @@ uint8_t account_decode (char value)
 void nano::uint256_union::encode_account (std::string & destination_a) const
 {
 	check (destination_a.empty ());
-	destination_a.reserve (65);
-	uint64_t check1 (0);
-	blake2b_state hash;
-	blake2b_init (&hash, 5);
-	blake2b_update (&hash, bytes.data (), bytes.size ());
-	blake2b_final (&hash, reinterpret_cast<uint8_t *> (&check1), 5);
-	nano::uint512_t number_l;
-	number_l.Parse (number ().ToString ());
-	number_l <<= 40;
-	number_l |= nano::uint512_t (check1);
-	for (auto i (0); i < 60; ++i)
-	{
-		uint8_t r ((number_l & static_cast<uint8_t> (0x1f)).ToInt ());
-		number_l >>= 5;
-		destination_a.push_back (account_encode (r));
-	}
-	destination_a.append ("_onan"); // nano_
-	std::reverse (destination_a.begin (), destination_a.end ());
+	std::array<char, 65> account;
+	encode_account (account);
+	destination_a.assign (account.data (), account.size ());
+}
+
+void nano::uint256_union::encode_account (std::array<char, 65> & destination_a) const
+{
+	uint8_t hash[checksum_size];
+	blake2b (hash, sizeof (hash), bytes.data (), bytes.size (), nullptr, 0);
+	std::memcpy (destination_a.data (), "nano_", 5);
+	encode_account_body (*this, hash, destination_a.data () + 5);
 }
 
 std::string nano::uint256_union::to_account () const
@@ -66,73 +147,57 @@ std::string nano::uint256_union::to_account () const
 
 bool nano::uint256_union::decode_account (std::string const & source_a)
 {
-	auto error (source_a.size () < 5);
+	return decode_account (source_a.data (), source_a.size ());
+}
+
+bool nano::uint256_union::decode_account (char const * source_a, size_t length_a)
+{
+	auto error (length_a < 5);
 	if (!error)
 	{
 		auto xrb_prefix (source_a[0] == 'x' && source_a[1] == 'r' && source_a[2] == 'b' && (source_a[3] == '_' || source_a[3] == '-'));
 		auto nano_prefix (source_a[0] == 'n' && source_a[1] == 'a' && source_a[2] == 'n' && source_a[3] == 'o' && (source_a[4] == '_' || source_a[4] == '-'));
-		error = (xrb_prefix && source_a.size () != 64) || (nano_prefix && source_a.size () != 65);
+		error = (xrb_prefix && length_a != 64) || (nano_prefix && length_a != 65) || (!xrb_prefix && !nano_prefix);
 		if (!error)
 		{
-			if (xrb_prefix || nano_prefix)
-			{
-				auto i (source_a.begin () + (xrb_prefix ? 4 : 5));
-				if (*i == '1' || *i == '3')
-				{
-					nano::uint512_t number_l;
-					for (auto j (source_a.end ()); !error && i != j; ++i)
-					{
-						uint8_t character (*i);
-						error = character < 0x30 || character >= 0x80;
-						if (!error)
-						{
-							uint8_t byte (account_decode (character));
-							error = byte == '~';
-							if (!error)
-							{
-								number_l <<= 5;
-								number_l += byte;
-							}
-						}
-					}
-					if (!error)
-					{
-						FString str = (number_l >> 40).ToString ();
-						str.RemoveFromStart ("0x");
-						*this = std::string (TCHAR_TO_UTF8 (*str));
-						uint64_t check1 ((number_l & static_cast<uint64_t> (0xffffffffff)).ToInt ());
-						uint64_t validation (0);
-						blake2b_state hash;
-						blake2b_init (&hash, 5);
-						blake2b_update (&hash, bytes.data (), bytes.size ());
-						blake2b_final (&hash, reinterpret_cast<uint8_t *> (&validation), 5);
-						error = check1 != validation;
-					}
-				}
-				else
-				{
-					error = true;
-				}
-			}
-			else
-			{
-				error = true;
-			}
+			auto body (source_a + (xrb_prefix ? 4 : 5));
+			// Only the lowest bit of the first character belongs to the key
+			error = (*body != '1' && *body != '3') || decode_account_body (body, *this);
 		}
 	}
 	return error;
 }
 
-nano::uint256_union::uint256_union (nano::uint256_t const & number_a)
+void nano::encode_accounts (nano::public_key const * keys_a, size_t count_a, std::array<char, 65> * accounts_a)
 {
-	nano::uint256_t number_l (number_a);
-	for (auto i (bytes.rbegin ()), n (bytes.rend ()); i != n; ++i)
+	// The checksums of a group are hashed together with blake2b_many
+	size_t const group_size (64);
+	uint8_t hashes[group_size][checksum_size];
+	uint8_t * out[group_size];
+	uint8_t const * in[group_size];
+	for (size_t start (0); start < count_a; start += group_size)
 	{
-		*i = static_cast<uint8_t> ((number_l & static_cast<uint8_t> (0xff)).ToInt ());
-		number_l >>= 8;
+		auto count (std::min (group_size, count_a - start));
+		for (size_t i (0); i < count; ++i)
+		{
+			out[i] = hashes[i];
+			in[i] = keys_a[start + i].bytes.data ();
+		}
+		nano::blake2b_many (out, checksum_size, in, sizeof (nano::public_key), count);
+		for (size_t i (0); i < count; ++i)
+		{
+			auto & account (accounts_a[start + i]);
+			std::memcpy (account.data (), "nano_", 5);
+			encode_account_body (keys_a[start + i], hashes[i], account.data () + 5);
+		}
 	}
 }
 
+nano::uint256_union::uint256_union (nano::uint256_t const & number_a)
+{
+	store_number (number_a, bytes.data ());
+}
+
 bool nano::uint256_union::operator== (nano::uint256_union const & other_a) const
 {
 	return bytes == other_a.bytes;
@@ -190,56 +255,36 @@ void nano::uint256_union::clear ()
 
 nano::uint256_t nano::uint256_union::number () const
 {
-	nano::uint256_t result;
-	auto shift (0);
-	for (auto i (bytes.begin ()), n (bytes.end ()); i != n; ++i)
-	{
-		result <<= shift;
-		result |= *i;
-		shift = 8;
-	}
-	return result;
+	return load_number<256> (bytes.data ());
 }
 
 void nano::uint256_union::encode_hex (std::string & text) const
 {
 	check (text.empty ());
-	auto temp = number ().ToString ();
-	temp.RemoveFromStart (TEXT ("0x"));
+	text.resize (bytes.size () * 2);
+	nano::codec::encode_hex (bytes.data (), bytes.size (), &text[0]);
+}
 
-	text = std::string (TCHAR_TO_UTF8 (*temp)); // stream.str();
+void nano::uint256_union::encode_hex (std::array<char, 64> & text) const
+{
+	nano::codec::encode_hex (bytes.data (), bytes.size (), text.data ());
 }
 
 bool nano::uint256_union::decode_hex (std::string const & text)
 {
-	auto error (false);
-	if (!text.empty () && text.size () <= 64)
-	{
-		nano::uint256_t number_l;
-		try
-		{
-			number_l.Parse (FString (text.c_str ()));
-			*this = number_l;
-		}
-		catch (std::runtime_error &)
-		{
-			error = true;
-		}
-	}
-	else
-	{
-		error = true;
-	}
-	return error;
+	return decode_hex (text.data (), text.size ());
+}
+
+bool nano::uint256_union::decode_hex (char const * text, size_t length)
+{
+	return nano::codec::decode_hex (text, length, bytes.data (), bytes.size ());
 }
 
 void nano::uint256_union::encode_dec (std::string & text) const
 {
 	check (text.empty ());
-
-	auto temp = number ().ToString ();
-	temp.RemoveFromStart (TEXT ("0x"));
-	text = BaseConverter::HexToDecimalConverter ().Convert (std::string (TCHAR_TO_UTF8 (*temp.ToUpper ())));
+	std::array<char, nano::codec::dec_digits (256)> buffer;
+	text.assign (buffer.data (), nano::codec::encode_dec (number (), buffer.data ()));
 }
 
 bool nano::uint256_union::decode_dec (std::string const & text)
@@ -248,15 +293,11 @@ bool nano::uint256_union::decode_dec (std::string const & text)
 	if (!error)
 	{
 		nano::uint256_t number_l;
-		try
+		error = nano::codec::decode_dec (text.data (), text.size (), number_l);
+		if (!error)
 		{
-			number_l.Parse (FString (BaseConverter::DecimalToHexConverter ().Convert (text).c_str ()));
 			*this = number_l;
 		}
-		catch (std::runtime_error &)
-		{
-			error = true;
-		}
 	}
 	return error;
 }
@@ -284,12 +325,7 @@ nano::uint512_union::uint512_union (nano::uint256_union const & upper, nano::uin
 
 nano::uint512_union::uint512_union (nano::uint512_t const & number_a)
 {
-	nano::uint512_t number_l (number_a);
-	for (auto i (bytes.rbegin ()), n (bytes.rend ()); i != n; ++i)
-	{
-		*i = static_cast<uint8_t> ((number_l & static_cast<uint8_t> (0xff)).ToInt ());
-		number_l >>= 8;
-	}
+	store_number (number_a, bytes.data ());
 }
 
 bool nano::uint512_union::is_zero () const
@@ -305,44 +341,29 @@ void nano::uint512_union::clear ()
 
 nano::uint512_t nano::uint512_union::number () const
 {
-	nano::uint512_t result;
-	auto shift (0);
-	for (auto i (bytes.begin ()), n (bytes.end ()); i != n; ++i)
-	{
-		result <<= shift;
-		result |= *i;
-		shift = 8;
-	}
-	return result;
+	return load_number<512> (bytes.data ());
 }
 
 void nano::uint512_union::encode_hex (std::string & text) const
 {
 	check (text.empty ());
+	text.resize (bytes.size () * 2);
+	nano::codec::encode_hex (bytes.data (), bytes.size (), &text[0]);
+}
 
-	auto temp = number ().ToString ();
-	temp.RemoveFromStart (TEXT ("0x"));
-
-	text = std::string (TCHAR_TO_UTF8 (*temp)); // stream.str();
+void nano::uint512_union::encode_hex (std::array<char, 128> & text) const
+{
+	nano::codec::encode_hex (bytes.data (), bytes.size (), text.data ());
 }
 
 bool nano::uint512_union::decode_hex (std::string const & text)
 {
-	auto error (text.size () > 128);
-	if (!error)
-	{
-		nano::uint512_t number_l;
-		try
-		{
-			number_l.Parse (FString (text.c_str ()));
-			*this = number_l;
-		}
-		catch (std::runtime_error &)
-		{
-			error = true;
-		}
-	}
-	return error;
+	return decode_hex (text.data (), text.size ());
+}
+
+bool nano::uint512_union::decode_hex (char const * text, size_t length)
+{
+	return nano::codec::decode_hex (text, length, bytes.data (), bytes.size ());
 }
 
 bool nano::uint512_union::operator!= (nano::uint512_union const & other_a) const
@@ -382,7 +403,7 @@ bool nano::raw_key::operator!= (nano::raw_key const & other_a) const
 nano::uint512_union nano::sign_message (nano::raw_key const & private_key, nano::public_key const & public_key, nano::uint256_union const & message)
 {
 	nano::uint512_union result;
-	ed25519_sign (message.bytes.data (), sizeof (message.bytes), private_key.data.bytes.data (), public_key.bytes.data (), result.bytes.data ());
+	nano::ed25519 ().sign (message.bytes.data (), sizeof (message.bytes), private_key.data.bytes.data (), public_key.bytes.data (), result.bytes.data ());
 	return result;
 }
 
@@ -396,22 +417,76 @@ void nano::deterministic_key (nano::uint256_union const & seed_a, uint32_t index
 	blake2b_final (&hash, prv_a.bytes.data (), prv_a.bytes.size ());
 }
 
+void nano::deterministic_keys (nano::uint256_union const & seed_a, uint32_t start_a, size_t count_a, nano::uint256_union * prv_a)
+{
+	// Each key is blake2b of seed || big endian index, a group of them is hashed together with blake2b_many
+	size_t const group_size (64);
+	size_t const message_size (sizeof (nano::uint256_union) + sizeof (uint32_t));
+	uint8_t messages[group_size][message_size];
+	uint8_t * out[group_size];
+	uint8_t const * in[group_size];
+	for (size_t i (0); i < group_size; ++i)
+	{
+		std::memcpy (messages[i], seed_a.bytes.data (), seed_a.bytes.size ());
+		in[i] = messages[i];
+	}
+	for (size_t start (0); start < count_a; start += group_size)
+	{
+		auto count (std::min (group_size, count_a - start));
+		for (size_t i (0); i < count; ++i)
+		{
+			auto index (static_cast<uint32_t> (start_a + start + i));
+			auto index_bytes (messages[i] + seed_a.bytes.size ());
+			for (auto byte (0); byte < 4; ++byte)
+			{
+				index_bytes[byte] = static_cast<uint8_t> (index >> (24 - byte * 8));
+			}
+			out[i] = prv_a[start + i].bytes.data ();
+		}
+		nano::blake2b_many (out, sizeof (nano::uint256_union), in, message_size, count);
+	}
+}
+
 nano::public_key nano::pub_key (nano::private_key const & privatekey_a)
 {
 	nano::uint256_union result;
-	ed25519_publickey (privatekey_a.bytes.data (), result.bytes.data ());
+	nano::ed25519 ().publickey (privatekey_a.bytes.data (), result.bytes.data ());
 	return result;
 }
 
 bool nano::validate_message (nano::public_key const & public_key, nano::uint256_union const & message, nano::uint512_union const & signature)
 {
-	auto result (0 != ed25519_sign_open (message.bytes.data (), sizeof (message.bytes), public_key.bytes.data (), signature.bytes.data ()));
+	auto result (0 != nano::ed25519 ().sign_open (message.bytes.data (), sizeof (message.bytes), public_key.bytes.data (), signature.bytes.data ()));
 	return result;
 }
 
 bool nano::validate_message_batch (const unsigned char ** m, size_t * mlen, const unsigned char ** pk, const unsigned char ** RS, size_t num, int * valid)
 {
-	bool result (0 == ed25519_sign_open_batch (m, mlen, pk, RS, num, valid));
+	bool result (0 == nano::ed25519 ().sign_open_batch (m, mlen, pk, RS, num, valid));
+	return result;
+}
+
+std::vector<bool> nano::validate_signatures (std::vector<nano::block_hash> const & hashes_a, std::vector<nano::account> const & accounts_a, std::vector<nano::signature> const & signatures_a)
+{
+	auto count (hashes_a.size ());
+	check (accounts_a.size () == count && signatures_a.size () == count);
+	std::vector<unsigned char const *> messages (count);
+	std::vector<size_t> lengths (count, sizeof (nano::block_hash));
+	std::vector<unsigned char const *> keys (count);
+	std::vector<unsigned char const *> signatures (count);
+	std::vector<int> valid (count);
+	for (size_t i (0); i < count; ++i)
+	{
+		messages[i] = hashes_a[i].bytes.data ();
+		keys[i] = accounts_a[i].bytes.data ();
+		signatures[i] = signatures_a[i].bytes.data ();
+	}
+	nano::validate_message_batch (messages.data (), lengths.data (), keys.data (), signatures.data (), count, valid.data ());
+	std::vector<bool> result (count);
+	for (size_t i (0); i < count; ++i)
+	{
+		result[i] = valid[i] == 1;
+	}
 	return result;
 }
 
@@ -429,12 +504,7 @@ nano::uint128_union::uint128_union (uint64_t value_a)
 
 nano::uint128_union::uint128_union (nano::uint128_t const & number_a)
 {
-	nano::uint128_t number_l (number_a);
-	for (auto i (bytes.rbegin ()), n (bytes.rend ()); i != n; ++i)
-	{
-		*i = static_cast<uint8_t> ((number_l & static_cast<uint8_t> (0xff)).ToInt ());
-		number_l >>= 8;
-	}
+	store_number (number_a, bytes.data ());
 }
 
 bool nano::uint128_union::operator== (nano::uint128_union const & other_a) const
@@ -459,67 +529,61 @@ bool nano::uint128_union::operator> (nano::uint128_union const & other_a) const
 
 nano::uint128_t nano::uint128_union::number () const
 {
-	nano::uint128_t result;
-	auto shift (0);
-	for (auto i (bytes.begin ()), n (bytes.end ()); i != n; ++i)
-	{
-		result <<= shift;
-		result |= *i;
-		shift = 8;
-	}
-	return result;
+	return load_number<128> (bytes.data ());
 }
 
 void nano::uint128_union::encode_hex (std::string & text) const
 {
 	check (text.empty ());
-	auto temp = number ().ToString ();
-	temp.RemoveFromStart (TEXT ("0x"));
-	text = std::string (TCHAR_TO_UTF8 (*temp)); 
+	text.resize (bytes.size () * 2);
+	nano::codec::encode_hex (bytes.data (), bytes.size (), &text[0]);
+}
+
+void nano::uint128_union::encode_hex (std::array<char, 32> & text) const
+{
+	nano::codec::encode_hex (bytes.data (), bytes.size (), text.data ());
 }
 
 bool nano::uint128_union::decode_hex (std::string const & text)
 {
-	auto error (text.size () > 32);
-	if (!error)
-	{
-		nano::uint128_t number_l;
-		try
-		{
-			number_l.Parse (FString (text.c_str ()));
-			*this = number_l;
-		}
-		catch (std::runtime_error &)
-		{
-			error = true;
-		}
-	}
-	return error;
+	return nano::codec::decode_hex (text.data (), text.size (), bytes.data (), bytes.size ());
 }
 
 void nano::uint128_union::encode_dec (std::string & text) const
 {
 	check (text.empty ());
-	auto temp = number ().ToString ();
-	temp.RemoveFromStart (TEXT ("0x"));
-	text = BaseConverter::HexToDecimalConverter ().Convert (std::string (TCHAR_TO_UTF8 (*temp.ToUpper ())));
+	std::array<char, 39> buffer;
+	text.assign (buffer.data (), encode_dec (buffer));
+}
+
+size_t nano::uint128_union::encode_dec (std::array<char, 39> & text) const
+{
+	return nano::codec::encode_dec (number (), text.data ());
 }
 
 bool nano::uint128_union::decode_dec (std::string const & text, bool decimal)
 {
-	auto error (text.size () > 39 || (text.size () > 1 && text.front () == '0' && !decimal) || (!text.empty () && text.front () == '-'));
+	return decode_dec_n (text.data (), text.size (), decimal);
+}
+
+bool nano::uint128_union::decode_dec_n (char const * text, size_t length, bool decimal)
+{
+	auto error ((length > 1 && text[0] == '0' && !decimal) || (length > 0 && text[0] == '-'));
+	// Leading zeroes don't count towards the 39 digits
+	while (length > 1 && text[0] == '0')
+	{
+		++text;
+		--length;
+	}
+	error = error || length > 39;
 	if (!error)
 	{
 		nano::uint128_t number_l;
-		try
+		error = nano::codec::decode_dec (text, length, number_l);
+		if (!error)
 		{
-			number_l.Parse (FString (BaseConverter::DecimalToHexConverter ().Convert (text).c_str ()));
 			*this = number_l;
 		}
-		catch (std::runtime_error &)
-		{
-			error = true;
-		}
 	}
 	return error;
 }
@@ -0,0 +1,327 @@
+// Copyright 2020 Wesley Shillingford. All rights reserved.
+#include <nano/pending_parser.h>
+
+#include <cctype>
+#include <cstring>
+
+namespace
+{
+/** Deeper than anything the node sends, stops a malformed response from recursing without bound */
+constexpr auto max_depth = 32;
+
+/** Tokens over the response bytes. Strings are left as they are in the response, escapes included */
+class reader final
+{
+public:
+	reader (char const * data_a, size_t size_a) :
+	next (data_a),
+	end (data_a + size_a)
+	{
+	}
+
+	/** Whether the next token starts with c_a, without consuming it */
+	bool peek (char c_a)
+	{
+		skip_whitespace ();
+		return next != end && *next == c_a;
+	}
+
+	/** Consumes c_a if it is next */
+	bool accept (char c_a)
+	{
+		auto result (peek (c_a));
+		if (result)
+		{
+			++next;
+		}
+		return result;
+	}
+
+	/** Returns true if c_a isn't next */
+	bool expect (char c_a)
+	{
+		return !accept (c_a);
+	}
+
+	bool string (char const *& text_a, size_t & length_a)
+	{
+		auto error (expect ('"'));
+		if (!error)
+		{
+			text_a = next;
+			while (next != end && *next != '"')
+			{
+				next += (*next == '\\' && next + 1 != end) ? 2 : 1;
+			}
+			error = next == end;
+			if (!error)
+			{
+				length_a = next - text_a;
+				++next;
+			}
+		}
+		return error;
+	}
+
+	/** Where the next token starts */
+	char const * position ()
+	{
+		skip_whitespace ();
+		return next;
+	}
+
+	/** Object key followed by its colon */
+	bool key (char const *& text_a, size_t & length_a)
+	{
+		return string (text_a, length_a) || expect (':');
+	}
+
+	/** Steps over any value */
+	bool skip (int depth_a = 0)
+	{
+		auto error (false);
+		char const * text (nullptr);
+		size_t length (0);
+		if (depth_a > max_depth)
+		{
+			error = true;
+		}
+		else if (peek ('"'))
+		{
+			error = string (text, length);
+		}
+		else if (accept ('{'))
+		{
+			if (!accept ('}'))
+			{
+				do
+				{
+					error = key (text, length) || skip (depth_a + 1);
+				} while (!error && accept (','));
+				error = error || expect ('}');
+			}
+		}
+		else if (accept ('['))
+		{
+			if (!accept (']'))
+			{
+				do
+				{
+					error = skip (depth_a + 1);
+				} while (!error && accept (','));
+				error = error || expect (']');
+			}
+		}
+		else
+		{
+			// Numbers, true, false and null
+			auto start (next);
+			while (next != end && (std::isalnum (static_cast<unsigned char> (*next)) || *next == '.' || *next == '-' || *next == '+'))
+			{
+				++next;
+			}
+			error = next == start;
+		}
+		return error;
+	}
+
+private:
+	void skip_whitespace ()
+	{
+		while (next != end && (*next == ' ' || *next == '\n' || *next == '\r' || *next == '\t'))
+		{
+			++next;
+		}
+	}
+
+	char const * next;
+	char const * end;
+};
+
+bool equals (char const * text_a, size_t length_a, char const * literal_a)
+{
+	return length_a == std::strlen (literal_a) && std::memcmp (text_a, literal_a, length_a) == 0;
+}
+
+/** { "amount": "...", "source": "..." }, other fields are skipped */
+bool parse_block (reader & reader_a, nano::pending_entry & entry_a)
+{
+	auto error (reader_a.expect ('{'));
+	if (!error && !reader_a.accept ('}'))
+	{
+		do
+		{
+			char const * text (nullptr);
+			size_t length (0);
+			error = reader_a.key (text, length);
+			if (!error)
+			{
+				if (equals (text, length, "amount"))
+				{
+					error = reader_a.string (text, length) || entry_a.amount.decode_dec_n (text, length);
+				}
+				else if (equals (text, length, "source"))
+				{
+					error = reader_a.string (text, length) || entry_a.source.decode_account (text, length);
+				}
+				else
+				{
+					error = reader_a.skip ();
+				}
+			}
+		} while (!error && reader_a.accept (','));
+		error = error || reader_a.expect ('}');
+	}
+	return error;
+}
+
+bool parse_blocks (reader & reader_a, std::function<bool (nano::pending_entry const &)> const & visit_a, bool & stopped_a)
+{
+	auto error (false);
+	char const * text (nullptr);
+	size_t length (0);
+	nano::pending_entry entry{};
+	if (reader_a.peek ('"'))
+	{
+		// No blocks
+		error = reader_a.string (text, length) || length != 0;
+	}
+	else if (reader_a.accept ('['))
+	{
+		if (!reader_a.accept (']'))
+		{
+			do
+			{
+				error = reader_a.string (text, length) || entry.hash.decode_hex (text, length);
+				stopped_a = !error && visit_a (entry);
+			} while (!error && !stopped_a && reader_a.accept (','));
+			error = error || (!stopped_a && reader_a.expect (']'));
+		}
+	}
+	else
+	{
+		error = reader_a.expect ('{');
+		if (!error && !reader_a.accept ('}'))
+		{
+			do
+			{
+				entry.amount.clear ();
+				entry.source.clear ();
+				error = reader_a.key (text, length) || entry.hash.decode_hex (text, length);
+				if (!error)
+				{
+					if (reader_a.peek ('"'))
+					{
+						error = reader_a.string (text, length) || entry.amount.decode_dec_n (text, length);
+					}
+					else
+					{
+						error = parse_block (reader_a, entry);
+					}
+				}
+				stopped_a = !error && visit_a (entry);
+			} while (!error && !stopped_a && reader_a.accept (','));
+			error = error || (!stopped_a && reader_a.expect ('}'));
+		}
+	}
+	return error;
+}
+}
+
+bool nano::parse_pending (char const * data_a, size_t size_a, std::function<bool (nano::pending_entry const &)> const & visit_a)
+{
+	reader reader (data_a, size_a);
+	auto error (reader.expect ('{'));
+	auto found (false);
+	auto stopped (false);
+	if (!error && !reader.accept ('}'))
+	{
+		do
+		{
+			char const * text (nullptr);
+			size_t length (0);
+			error = reader.key (text, length);
+			if (!error)
+			{
+				if (equals (text, length, "blocks"))
+				{
+					found = true;
+					error = parse_blocks (reader, visit_a, stopped);
+				}
+				else
+				{
+					error = equals (text, length, "error") || reader.skip ();
+				}
+			}
+		} while (!error && !stopped && reader.accept (','));
+		error = error || (!stopped && reader.expect ('}'));
+	}
+	return error || !found;
+}
+
+bool nano::parse_accounts_pending (char const * data_a, size_t size_a, std::function<void (char const *, size_t, char const *, size_t)> const & visit_a)
+{
+	reader reader (data_a, size_a);
+	auto error (reader.expect ('{'));
+	auto found (false);
+	if (!error && !reader.accept ('}'))
+	{
+		do
+		{
+			char const * text (nullptr);
+			size_t length (0);
+			error = reader.key (text, length);
+			if (!error)
+			{
+				if (equals (text, length, "blocks"))
+				{
+					found = true;
+					if (reader.peek ('"'))
+					{
+						// None of the accounts have any
+						error = reader.string (text, length) || length != 0;
+					}
+					else
+					{
+						error = reader.expect ('{');
+						if (!error && !reader.accept ('}'))
+						{
+							do
+							{
+								error = reader.key (text, length);
+								if (!error)
+								{
+									auto blocks (reader.position ());
+									error = reader.skip ();
+									if (!error)
+									{
+										visit_a (text, length, blocks, reader.position () - blocks);
+									}
+								}
+							} while (!error && reader.accept (','));
+							error = error || reader.expect ('}');
+						}
+					}
+				}
+				else
+				{
+					error = equals (text, length, "error") || reader.skip ();
+				}
+			}
+		} while (!error && reader.accept (','));
+		error = error || reader.expect ('}');
+	}
+	return error || !found;
+}
+
+bool nano::parse_pending (char const * data_a, size_t size_a, std::vector<nano::pending_entry> & entries_a, size_t max_a)
+{
+	auto start (entries_a.size ());
+	return nano::parse_pending (data_a, size_a, [&entries_a, start, max_a](nano::pending_entry const & entry_a) {
+		if (entries_a.size () - start < max_a)
+		{
+			entries_a.push_back (entry_a);
+		}
+		return entries_a.size () - start >= max_a;
+	});
+}
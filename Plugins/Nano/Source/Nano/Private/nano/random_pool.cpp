@@ -0,0 +1,206 @@
+// Copyright 2020 Wesley Shillingford. All rights reserved.
+#include <nano/random_pool.h>
+
+#include <duthomhas/csprng.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+
+#if !defined(_WIN32)
+#include <pthread.h>
+#endif
+
+namespace
+{
+std::atomic<uint64_t> reseed_bytes (1 << 20);
+std::atomic<bool> detect_fork (true);
+
+#if !defined(_WIN32)
+/** Bumped in the child after fork, so each thread's generator can tell its state was copied from the parent */
+std::atomic<uint64_t> fork_generation (0);
+
+void fork_child ()
+{
+	++fork_generation;
+}
+#endif
+
+uint64_t current_fork_generation ()
+{
+#if !defined(_WIN32)
+	static auto registered (pthread_atfork (nullptr, nullptr, fork_child) == 0);
+	(void)registered;
+	return fork_generation.load (std::memory_order_relaxed);
+#else
+	return 0;
+#endif
+}
+
+/** Stores the compiler can't drop because the memory is about to be freed */
+void wipe (void * data_a, size_t size_a)
+{
+	auto volatile * bytes (static_cast<uint8_t volatile *> (data_a));
+	for (size_t i (0); i < size_a; ++i)
+	{
+		bytes[i] = 0;
+	}
+}
+
+uint32_t rotl (uint32_t value_a, int bits_a)
+{
+	return (value_a << bits_a) | (value_a >> (32 - bits_a));
+}
+
+#define NANO_CHACHA_QUARTER(a, b, c, d) \
+	a += b;                             \
+	d = rotl (d ^ a, 16);               \
+	c += d;                             \
+	b = rotl (b ^ c, 12);               \
+	a += b;                             \
+	d = rotl (d ^ a, 8);                \
+	c += d;                             \
+	b = rotl (b ^ c, 7);
+
+/** The RFC 8439 block function, 64 bytes of keystream for a key, block counter and nonce */
+void chacha20_block (uint32_t const * key_a, uint32_t counter_a, uint32_t const * nonce_a, uint8_t * output_a)
+{
+	std::array<uint32_t, 16> input{ 0x61707865, 0x3320646e, 0x79622d32, 0x6b206574 };
+	std::copy (key_a, key_a + 8, input.begin () + 4);
+	input[12] = counter_a;
+	std::copy (nonce_a, nonce_a + 3, input.begin () + 13);
+	auto x (input);
+	for (auto round (0); round < 10; ++round)
+	{
+		NANO_CHACHA_QUARTER (x[0], x[4], x[8], x[12])
+		NANO_CHACHA_QUARTER (x[1], x[5], x[9], x[13])
+		NANO_CHACHA_QUARTER (x[2], x[6], x[10], x[14])
+		NANO_CHACHA_QUARTER (x[3], x[7], x[11], x[15])
+		NANO_CHACHA_QUARTER (x[0], x[5], x[10], x[15])
+		NANO_CHACHA_QUARTER (x[1], x[6], x[11], x[12])
+		NANO_CHACHA_QUARTER (x[2], x[7], x[8], x[13])
+		NANO_CHACHA_QUARTER (x[3], x[4], x[9], x[14])
+	}
+	for (auto i (0); i < 16; ++i)
+	{
+		auto word (x[i] + input[i]);
+		for (auto byte (0); byte < 4; ++byte)
+		{
+			output_a[i * 4 + byte] = static_cast<uint8_t> (word >> (byte * 8));
+		}
+	}
+	wipe (x.data (), sizeof (x));
+	wipe (input.data (), sizeof (input));
+}
+
+#undef NANO_CHACHA_QUARTER
+
+class chacha20_generator final
+{
+public:
+	chacha20_generator ()
+	{
+		reseed ();
+	}
+
+	~chacha20_generator ()
+	{
+		wipe (key.data (), sizeof (key));
+		wipe (buffer.data (), buffer.size ());
+	}
+
+	void generate (uint8_t * output_a, size_t size_a)
+	{
+		auto interval (reseed_bytes.load (std::memory_order_relaxed));
+		if ((interval != 0 && generated >= interval) || (detect_fork.load (std::memory_order_relaxed) && fork != current_fork_generation ()))
+		{
+			reseed ();
+		}
+		generated += size_a;
+		while (size_a > 0)
+		{
+			if (position == buffer.size ())
+			{
+				refill ();
+			}
+			auto count (std::min (size_a, buffer.size () - position));
+			std::memcpy (output_a, buffer.data () + position, count);
+			wipe (buffer.data () + position, count);
+			position += count;
+			output_a += count;
+			size_a -= count;
+		}
+	}
+
+	void reseed ()
+	{
+		duthomhas::csprng os;
+		os (key.data (), key.size ());
+		wipe (buffer.data (), buffer.size ());
+		position = buffer.size ();
+		generated = 0;
+		fork = current_fork_generation ();
+	}
+
+private:
+	/** Rekeys with the first 32 bytes of the new keystream, the rest is served */
+	void refill ()
+	{
+		uint32_t const nonce[3] = { 0, 0, 0 };
+		for (size_t block (0); block < buffer.size () / 64; ++block)
+		{
+			chacha20_block (key.data (), static_cast<uint32_t> (block), nonce, buffer.data () + block * 64);
+		}
+		for (auto i (0); i < 8; ++i)
+		{
+			auto bytes (buffer.data () + i * 4);
+			key[i] = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<uint32_t> (bytes[3]) << 24);
+		}
+		wipe (buffer.data (), sizeof (key));
+		position = sizeof (key);
+	}
+
+	std::array<uint32_t, 8> key;
+	std::array<uint8_t, 512> buffer;
+	size_t position{ 0 };
+	uint64_t generated{ 0 };
+	uint64_t fork{ 0 };
+};
+
+chacha20_generator & generator ()
+{
+	static thread_local chacha20_generator generator;
+	return generator;
+}
+}
+
+void nano::random_pool::generate_block (uint8_t * output_a, size_t size_a)
+{
+	generator ().generate (output_a, size_a);
+}
+
+void nano::random_pool::reseed ()
+{
+	generator ().reseed ();
+}
+
+void nano::random_pool::set_reseed_interval (uint64_t bytes_a)
+{
+	reseed_bytes = bytes_a;
+}
+
+uint64_t nano::random_pool::reseed_interval ()
+{
+	return reseed_bytes;
+}
+
+void nano::random_pool::set_fork_detection (bool enabled_a)
+{
+	detect_fork = enabled_a;
+}
+
+bool nano::random_pool::fork_detection ()
+{
+	return detect_fork;
+}
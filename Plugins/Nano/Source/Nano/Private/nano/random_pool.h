@@ -0,0 +1,39 @@
+// Copyright 2020 Wesley Shillingford. All rights reserved.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace nano
+{
+/**
+ * Random bytes for seeds, signing nonces and batch verification without a syscall per call. Each thread keeps a ChaCha20
+ * generator keyed from the OS generator, refilled a buffer at a time with fast key erasure: the first 32 bytes of every
+ * refill rekey it and bytes are wiped from the buffer once handed out, so the state never reveals earlier output.
+ * A thread rekeys from the OS after reseed_interval bytes and, with fork detection on, in a child process after fork.
+ */
+class random_pool final
+{
+public:
+	random_pool () = delete;
+
+	static void generate_block (uint8_t * output_a, size_t size_a);
+
+	template <typename T>
+	static void generate (T & value_a)
+	{
+		generate_block (reinterpret_cast<uint8_t *> (&value_a), sizeof (value_a));
+	}
+
+	/** Rekeys the calling thread's generator from the OS */
+	static void reseed ();
+
+	/** Bytes a thread serves before it rekeys from the OS, 0 only reseeds on fork. Defaults to 1 MiB */
+	static void set_reseed_interval (uint64_t bytes_a);
+	static uint64_t reseed_interval ();
+
+	/** Whether child processes reseed instead of repeating the parent's output. On by default, no effect on Windows */
+	static void set_fork_detection (bool enabled_a);
+	static bool fork_detection ();
+};
+}
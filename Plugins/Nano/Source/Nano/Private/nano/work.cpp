@@ -0,0 +1,443 @@
+// Copyright 2020 Wesley Shillingford. All rights reserved.
+#include <nano/codecs.h>
+#include <nano/cpu.h>
+#include <nano/work.h>
+
+#include <blake2/blake2.h>
+
+#include <algorithm>
+#include <random>
+
+#if defined(NANO_SSE2)
+#include <immintrin.h>
+#endif
+
+namespace
+{
+uint64_t constexpr blake2b_iv[8] = {
+	0x6a09e667f3bcc908, 0xbb67ae8584caa73b, 0x3c6ef372fe94f82b, 0xa54ff53a5f1d36f1,
+	0x510e527fade682d1, 0x9b05688c2b3e6c1f, 0x1f83d9abfb41bd6b, 0x5be0cd19137e2179
+};
+
+// Parameter block of an unkeyed 8 byte digest, only the first word differs from the IV
+uint64_t constexpr work_h0 = blake2b_iv[0] ^ 0x01010008;
+// The only block is the last one, 40 bytes long
+uint64_t constexpr work_v12 = blake2b_iv[4] ^ 40;
+uint64_t constexpr work_v14 = ~blake2b_iv[6];
+
+uint8_t constexpr blake2b_sigma[12][16] = {
+	{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+	{ 14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3 },
+	{ 11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4 },
+	{ 7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8 },
+	{ 9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13 },
+	{ 2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9 },
+	{ 12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11 },
+	{ 13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10 },
+	{ 6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5 },
+	{ 10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0 },
+	{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+	{ 14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3 }
+};
+
+uint64_t load_le64 (uint8_t const * bytes_a)
+{
+	uint64_t result (0);
+	for (auto i (0); i < 8; ++i)
+	{
+		result |= static_cast<uint64_t> (bytes_a[i]) << (8 * i);
+	}
+	return result;
+}
+
+// The kernels below share these, each defines ADD, XOR and the ROTn rotations for its own word type first.
+// Message words 5 to 15 are zero so those additions are dropped by the compiler.
+// clang-format off
+#define NANO_WORK_G(r, i, a, b, c, d) \
+	a = ADD (ADD (a, b), m[blake2b_sigma[r][2 * i]]); d = ROT32 (XOR (d, a)); c = ADD (c, d); b = ROT24 (XOR (b, c)); \
+	a = ADD (ADD (a, b), m[blake2b_sigma[r][2 * i + 1]]); d = ROT16 (XOR (d, a)); c = ADD (c, d); b = ROT63 (XOR (b, c));
+
+#define NANO_WORK_ROUND(r) \
+	NANO_WORK_G (r, 0, v[0], v[4], v[8], v[12]) \
+	NANO_WORK_G (r, 1, v[1], v[5], v[9], v[13]) \
+	NANO_WORK_G (r, 2, v[2], v[6], v[10], v[14]) \
+	NANO_WORK_G (r, 3, v[3], v[7], v[11], v[15]) \
+	NANO_WORK_G (r, 4, v[0], v[5], v[10], v[15]) \
+	NANO_WORK_G (r, 5, v[1], v[6], v[11], v[12]) \
+	NANO_WORK_G (r, 6, v[2], v[7], v[8], v[13]) \
+	NANO_WORK_G (r, 7, v[3], v[4], v[9], v[14])
+
+#define NANO_WORK_ROUNDS \
+	NANO_WORK_ROUND (0) NANO_WORK_ROUND (1) NANO_WORK_ROUND (2) NANO_WORK_ROUND (3) \
+	NANO_WORK_ROUND (4) NANO_WORK_ROUND (5) NANO_WORK_ROUND (6) NANO_WORK_ROUND (7) \
+	NANO_WORK_ROUND (8) NANO_WORK_ROUND (9) NANO_WORK_ROUND (10) NANO_WORK_ROUND (11)
+// clang-format on
+
+#define ADD(a, b) ((a) + (b))
+#define XOR(a, b) ((a) ^ (b))
+#define ROT32(a) (((a) >> 32) | ((a) << 32))
+#define ROT24(a) (((a) >> 24) | ((a) << 40))
+#define ROT16(a) (((a) >> 16) | ((a) << 48))
+#define ROT63(a) (((a) >> 63) | ((a) << 1))
+
+void work_values_scalar (uint64_t const (&root_a)[4], uint64_t const * nonces_a, uint64_t * values_a, size_t count_a)
+{
+	for (size_t n (0); n < count_a; ++n)
+	{
+		uint64_t const m[16] = { nonces_a[n], root_a[0], root_a[1], root_a[2], root_a[3] };
+		uint64_t v[16] = {
+			work_h0, blake2b_iv[1], blake2b_iv[2], blake2b_iv[3], blake2b_iv[4], blake2b_iv[5], blake2b_iv[6], blake2b_iv[7],
+			blake2b_iv[0], blake2b_iv[1], blake2b_iv[2], blake2b_iv[3], work_v12, blake2b_iv[5], work_v14, blake2b_iv[7]
+		};
+		NANO_WORK_ROUNDS
+		values_a[n] = work_h0 ^ v[0] ^ v[8];
+	}
+}
+
+#undef ADD
+#undef XOR
+#undef ROT32
+#undef ROT24
+#undef ROT16
+#undef ROT63
+
+#if defined(NANO_SSE2)
+#define ADD(a, b) _mm_add_epi64 (a, b)
+#define XOR(a, b) _mm_xor_si128 (a, b)
+#define ROT32(a) _mm_shuffle_epi32 (a, _MM_SHUFFLE (2, 3, 0, 1))
+#define ROT24(a) _mm_shuffle_epi8 (a, rot24)
+#define ROT16(a) _mm_shuffle_epi8 (a, rot16)
+#define ROT63(a) _mm_xor_si128 (_mm_srli_epi64 (a, 63), _mm_add_epi64 (a, a))
+
+NANO_TARGET ("sse4.1")
+void work_values_sse41 (uint64_t const (&root_a)[4], uint64_t const * nonces_a, uint64_t * values_a)
+{
+	auto const rot24 (_mm_setr_epi8 (3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10));
+	auto const rot16 (_mm_setr_epi8 (2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9));
+	auto const zero (_mm_setzero_si128 ());
+	__m128i const m[16] = {
+		_mm_loadu_si128 (reinterpret_cast<__m128i const *> (nonces_a)),
+		_mm_set1_epi64x (static_cast<int64_t> (root_a[0])), _mm_set1_epi64x (static_cast<int64_t> (root_a[1])),
+		_mm_set1_epi64x (static_cast<int64_t> (root_a[2])), _mm_set1_epi64x (static_cast<int64_t> (root_a[3])),
+		zero, zero, zero, zero, zero, zero, zero, zero, zero, zero, zero
+	};
+	__m128i v[16];
+	for (auto i (0); i < 8; ++i)
+	{
+		v[i] = _mm_set1_epi64x (static_cast<int64_t> (i == 0 ? work_h0 : blake2b_iv[i]));
+		v[i + 8] = _mm_set1_epi64x (static_cast<int64_t> (i == 4 ? work_v12 : i == 6 ? work_v14 : blake2b_iv[i]));
+	}
+	NANO_WORK_ROUNDS
+	auto result (_mm_xor_si128 (_mm_xor_si128 (v[0], v[8]), _mm_set1_epi64x (static_cast<int64_t> (work_h0))));
+	_mm_storeu_si128 (reinterpret_cast<__m128i *> (values_a), result);
+}
+
+#undef ADD
+#undef XOR
+#undef ROT32
+#undef ROT24
+#undef ROT16
+#undef ROT63
+
+#define ADD(a, b) _mm256_add_epi64 (a, b)
+#define XOR(a, b) _mm256_xor_si256 (a, b)
+#define ROT32(a) _mm256_shuffle_epi32 (a, _MM_SHUFFLE (2, 3, 0, 1))
+#define ROT24(a) _mm256_shuffle_epi8 (a, rot24)
+#define ROT16(a) _mm256_shuffle_epi8 (a, rot16)
+#define ROT63(a) _mm256_xor_si256 (_mm256_srli_epi64 (a, 63), _mm256_add_epi64 (a, a))
+
+NANO_TARGET ("avx2")
+void work_values_avx2 (uint64_t const (&root_a)[4], uint64_t const * nonces_a, uint64_t * values_a)
+{
+	auto const rot24 (_mm256_setr_epi8 (3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10, 3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10));
+	auto const rot16 (_mm256_setr_epi8 (2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9, 2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9));
+	auto const zero (_mm256_setzero_si256 ());
+	__m256i const m[16] = {
+		_mm256_loadu_si256 (reinterpret_cast<__m256i const *> (nonces_a)),
+		_mm256_set1_epi64x (static_cast<int64_t> (root_a[0])), _mm256_set1_epi64x (static_cast<int64_t> (root_a[1])),
+		_mm256_set1_epi64x (static_cast<int64_t> (root_a[2])), _mm256_set1_epi64x (static_cast<int64_t> (root_a[3])),
+		zero, zero, zero, zero, zero, zero, zero, zero, zero, zero, zero
+	};
+	__m256i v[16];
+	for (auto i (0); i < 8; ++i)
+	{
+		v[i] = _mm256_set1_epi64x (static_cast<int64_t> (i == 0 ? work_h0 : blake2b_iv[i]));
+		v[i + 8] = _mm256_set1_epi64x (static_cast<int64_t> (i == 4 ? work_v12 : i == 6 ? work_v14 : blake2b_iv[i]));
+	}
+	NANO_WORK_ROUNDS
+	auto result (_mm256_xor_si256 (_mm256_xor_si256 (v[0], v[8]), _mm256_set1_epi64x (static_cast<int64_t> (work_h0))));
+	_mm256_storeu_si256 (reinterpret_cast<__m256i *> (values_a), result);
+}
+
+#undef ADD
+#undef XOR
+#undef ROT32
+#undef ROT24
+#undef ROT16
+#undef ROT63
+#endif
+
+#undef NANO_WORK_G
+#undef NANO_WORK_ROUND
+#undef NANO_WORK_ROUNDS
+}
+
+uint64_t nano::work_value (nano::block_hash const & root_a, uint64_t work_a)
+{
+	uint8_t nonce[8];
+	for (auto i (0); i < 8; ++i)
+	{
+		nonce[i] = static_cast<uint8_t> (work_a >> (8 * i));
+	}
+	uint8_t digest[8];
+	blake2b_state hash;
+	blake2b_init (&hash, sizeof (digest));
+	blake2b_update (&hash, nonce, sizeof (nonce));
+	blake2b_update (&hash, root_a.bytes.data (), root_a.bytes.size ());
+	blake2b_final (&hash, digest, sizeof (digest));
+	uint64_t result (0);
+	for (auto i (0); i < 8; ++i)
+	{
+		result |= static_cast<uint64_t> (digest[i]) << (8 * i);
+	}
+	return result;
+}
+
+bool nano::work_validate (nano::block_hash const & root_a, uint64_t work_a, uint64_t threshold_a)
+{
+	uint64_t value;
+	nano::work_values (root_a, &work_a, &value, 1);
+	return value < threshold_a;
+}
+
+double nano::work_multiplier (uint64_t difficulty_a, uint64_t base_a)
+{
+	// Expected attempts are 2^64 / (2^64 - difficulty)
+	return static_cast<double> (~base_a + 1) / static_cast<double> (~difficulty_a + 1);
+}
+
+uint64_t nano::work_difficulty (double multiplier_a, uint64_t base_a)
+{
+	return ~static_cast<uint64_t> (static_cast<double> (~base_a + 1) / multiplier_a) + 1;
+}
+
+void nano::work_validate (nano::block_hash const * roots_a, uint64_t const * works_a, size_t count_a, uint64_t threshold_a, bool * errors_a)
+{
+	for (size_t i (0); i < count_a; ++i)
+	{
+		errors_a[i] = nano::work_validate (roots_a[i], works_a[i], threshold_a);
+	}
+}
+
+nano::work_kernel nano::best_work_kernel ()
+{
+	auto const & cpu (nano::cpu ());
+	return cpu.avx2 ? nano::work_kernel::avx2 : cpu.sse41 ? nano::work_kernel::sse41 : nano::work_kernel::scalar;
+}
+
+void nano::work_values (nano::work_kernel kernel_a, nano::block_hash const & root_a, uint64_t const * nonces_a, uint64_t * values_a, size_t count_a)
+{
+	uint64_t const root[4] = { load_le64 (&root_a.bytes[0]), load_le64 (&root_a.bytes[8]), load_le64 (&root_a.bytes[16]), load_le64 (&root_a.bytes[24]) };
+	size_t i (0);
+#if defined(NANO_SSE2)
+	if (kernel_a == nano::work_kernel::avx2)
+	{
+		for (; i + 4 <= count_a; i += 4)
+		{
+			work_values_avx2 (root, nonces_a + i, values_a + i);
+		}
+	}
+	if (kernel_a != nano::work_kernel::scalar)
+	{
+		for (; i + 2 <= count_a; i += 2)
+		{
+			work_values_sse41 (root, nonces_a + i, values_a + i);
+		}
+	}
+#endif
+	work_values_scalar (root, nonces_a + i, values_a + i, count_a - i);
+}
+
+void nano::work_values (nano::block_hash const & root_a, uint64_t const * nonces_a, uint64_t * values_a, size_t count_a)
+{
+	static auto const kernel (nano::best_work_kernel ());
+	nano::work_values (kernel, root_a, nonces_a, values_a, count_a);
+}
+
+void nano::encode_work (uint64_t work_a, std::array<char, 16> & text_a)
+{
+	uint8_t bytes[8];
+	for (auto i (0); i < 8; ++i)
+	{
+		bytes[i] = static_cast<uint8_t> (work_a >> (56 - 8 * i));
+	}
+	nano::codec::encode_hex (bytes, sizeof (bytes), text_a.data ());
+}
+
+bool nano::decode_work (char const * text_a, size_t length_a, uint64_t & work_a)
+{
+	uint8_t bytes[8];
+	auto error (nano::codec::decode_hex (text_a, length_a, bytes, sizeof (bytes)));
+	if (!error)
+	{
+		work_a = 0;
+		for (auto byte : bytes)
+		{
+			work_a = (work_a << 8) | byte;
+		}
+	}
+	return error;
+}
+
+nano::work_pool::work_pool (unsigned threads_a)
+{
+	if (threads_a == 0)
+	{
+		threads_a = std::max (std::thread::hardware_concurrency (), 2u) - 1;
+	}
+	for (unsigned i (0); i < threads_a; ++i)
+	{
+		threads.emplace_back ([this, i]() { loop (i); });
+	}
+}
+
+nano::work_pool::~work_pool ()
+{
+	stop ();
+}
+
+void nano::work_pool::loop (uint64_t thread_a)
+{
+	// xorshift64*, seeded differently per thread so they search different parts of the nonce space
+	std::random_device device;
+	auto rng ((((static_cast<uint64_t> (device ()) << 32) | device ()) ^ (thread_a * 0x9e3779b97f4a7c15)) | 1);
+	std::unique_lock<std::mutex> lock (mutex);
+	while (!done)
+	{
+		if (pending.empty ())
+		{
+			producer_condition.wait (lock);
+			continue;
+		}
+		auto root (pending.front ().root);
+		auto difficulty (pending.front ().difficulty);
+		auto ticket_l (ticket.load ());
+		lock.unlock ();
+		uint64_t work (0);
+		uint64_t output (0);
+		while (ticket == ticket_l && output < difficulty)
+		{
+			// The ticket is shared by every thread so only check it every so often
+			for (auto batch (0); batch < 32 && output < difficulty; ++batch)
+			{
+				// A few nonces at a time so the SIMD kernels can hash them side by side
+				uint64_t nonces[8];
+				uint64_t values[8];
+				for (auto & nonce : nonces)
+				{
+					rng ^= rng >> 12;
+					rng ^= rng << 25;
+					rng ^= rng >> 27;
+					nonce = rng * 0x2545f4914f6cdd1d;
+				}
+				nano::work_values (root, nonces, values, 8);
+				for (auto i (0); i < 8 && output < difficulty; ++i)
+				{
+					work = nonces[i];
+					output = values[i];
+				}
+				attempted += 8;
+			}
+		}
+		lock.lock ();
+		if (ticket == ticket_l && output >= difficulty)
+		{
+			// This thread found it first, the others move on once they see the ticket change
+			++ticket;
+			auto callback (std::move (pending.front ().callback));
+			pending.pop_front ();
+			lock.unlock ();
+			callback (false, work);
+			lock.lock ();
+		}
+	}
+}
+
+void nano::work_pool::generate (nano::block_hash const & root_a, uint64_t difficulty_a, callback_type callback_a)
+{
+	auto stopped (false);
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		stopped = done;
+		if (!stopped)
+		{
+			pending.push_back ({ root_a, difficulty_a, std::move (callback_a) });
+		}
+	}
+	producer_condition.notify_all ();
+	if (stopped)
+	{
+		callback_a (true, 0);
+	}
+}
+
+void nano::work_pool::cancel (nano::block_hash const & root_a)
+{
+	std::vector<callback_type> cancelled;
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		if (!pending.empty () && pending.front ().root == root_a)
+		{
+			++ticket;
+		}
+		auto first (std::stable_partition (pending.begin (), pending.end (), [&root_a](item const & item_a) { return item_a.root != root_a; }));
+		for (auto i (first); i != pending.end (); ++i)
+		{
+			cancelled.push_back (std::move (i->callback));
+		}
+		pending.erase (first, pending.end ());
+	}
+	for (auto & callback : cancelled)
+	{
+		callback (true, 0);
+	}
+}
+
+void nano::work_pool::stop ()
+{
+	std::deque<item> cancelled;
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		done = true;
+		++ticket;
+		cancelled.swap (pending);
+	}
+	producer_condition.notify_all ();
+	for (auto & thread : threads)
+	{
+		if (thread.joinable ())
+		{
+			thread.join ();
+		}
+	}
+	for (auto & item : cancelled)
+	{
+		item.callback (true, 0);
+	}
+}
+
+size_t nano::work_pool::size ()
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	return pending.size ();
+}
+
+size_t nano::work_pool::thread_count () const
+{
+	return threads.size ();
+}
+
+uint64_t nano::work_pool::attempts () const
+{
+	return attempted;
+}
@@ -0,0 +1,130 @@
+// Copyright 2020 Wesley Shillingford. All rights reserved.
+#include <nano/work_cache.h>
+
+#include <blake2/blake2.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+void store_le64 (uint64_t value_a, uint8_t * bytes_a)
+{
+	for (auto i (0); i < 8; ++i)
+	{
+		bytes_a[i] = static_cast<uint8_t> (value_a >> (8 * i));
+	}
+}
+
+uint64_t load_le64 (uint8_t const * bytes_a)
+{
+	uint64_t result (0);
+	for (auto i (0); i < 8; ++i)
+	{
+		result |= static_cast<uint64_t> (bytes_a[i]) << (8 * i);
+	}
+	return result;
+}
+
+// Covers everything before it in the record
+void checksum (uint8_t const * record_a, uint8_t * checksum_a)
+{
+	blake2b (checksum_a, 8, record_a, nano::work_cache::record_size - 8, nullptr, 0);
+}
+
+void encode (nano::block_hash const & root_a, uint64_t work_a, uint64_t difficulty_a, uint8_t * record_a)
+{
+	std::copy (root_a.bytes.begin (), root_a.bytes.end (), record_a);
+	store_le64 (work_a, record_a + 32);
+	store_le64 (difficulty_a, record_a + 40);
+	checksum (record_a, record_a + 48);
+}
+}
+
+std::array<uint8_t, nano::work_cache::header_size> const nano::work_cache::header{ { 'n', 'a', 'n', 'o', 'w', 'r', 'k', 1 } };
+
+size_t nano::work_cache::load (uint8_t const * data_a, size_t size_a)
+{
+	entries.clear ();
+	records = 0;
+	size_t valid (0);
+	if (size_a >= header_size && std::equal (header.begin (), header.end (), data_a))
+	{
+		valid = header_size;
+		while (valid + record_size <= size_a)
+		{
+			auto record_l (data_a + valid);
+			uint8_t expected[8];
+			checksum (record_l, expected);
+			if (std::memcmp (expected, record_l + record_size - 8, sizeof (expected)) != 0)
+			{
+				break;
+			}
+			nano::block_hash root;
+			std::copy (record_l, record_l + 32, root.bytes.begin ());
+			auto difficulty (load_le64 (record_l + 40));
+			if (difficulty != 0)
+			{
+				auto & entry_l (*entries.emplace (root).first);
+				entry_l.work = load_le64 (record_l + 32);
+				entry_l.difficulty = difficulty;
+			}
+			else
+			{
+				entries.erase (root);
+			}
+			++records;
+			valid += record_size;
+		}
+	}
+	return valid;
+}
+
+nano::work_cache::entry const * nano::work_cache::find (nano::block_hash const & root_a) const
+{
+	return entries.find (root_a);
+}
+
+void nano::work_cache::insert (nano::block_hash const & root_a, uint64_t work_a, uint64_t difficulty_a, record & record_a)
+{
+	check (difficulty_a != 0);
+	auto & entry_l (*entries.emplace (root_a).first);
+	entry_l.work = work_a;
+	entry_l.difficulty = difficulty_a;
+	encode (root_a, work_a, difficulty_a, record_a.data ());
+	++records;
+}
+
+bool nano::work_cache::erase (nano::block_hash const & root_a, record & record_a)
+{
+	auto erased (entries.erase (root_a));
+	if (erased)
+	{
+		encode (root_a, 0, 0, record_a.data ());
+		++records;
+	}
+	return erased;
+}
+
+std::vector<uint8_t> nano::work_cache::compact ()
+{
+	std::vector<uint8_t> result (header_size + entries.size () * record_size);
+	std::copy (header.begin (), header.end (), result.begin ());
+	records = entries.size ();
+	auto record_l (result.data () + header_size);
+	entries.for_each ([&record_l](nano::block_hash const & root_a, entry const & entry_a) {
+		encode (root_a, entry_a.work, entry_a.difficulty, record_l);
+		record_l += record_size;
+	});
+	return result;
+}
+
+bool nano::work_cache::needs_compaction () const
+{
+	return records > 64 && records > entries.size () * 2;
+}
+
+size_t nano::work_cache::size () const
+{
+	return entries.size ();
+}
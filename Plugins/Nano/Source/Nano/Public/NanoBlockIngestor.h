@@ -0,0 +1,182 @@
+// Copyright 2020 Wesley Shillingford. All rights reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Dom/JsonObject.h"
+#include "NanoManager.h"
+
+#include <nano/blocks.h>
+#include <nano/key_map.h>
+
+#include <array>
+#include <vector>
+
+#include "NanoBlockIngestor.generated.h"
+
+UENUM(BlueprintType)
+enum class FIngestStage : uint8 { decode, verify, work, frontier, process };
+
+// A block made and signed by a client, which hands it to the server to check and publish
+USTRUCT(BlueprintType)
+struct NANO_API FIngestBlock {
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "IngestBlock")
+	FString account;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "IngestBlock")
+	FString previous;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "IngestBlock")
+	FString representative;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "IngestBlock")
+	FString balance;
+
+	/** Hex or an account */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "IngestBlock")
+	FString link;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "IngestBlock")
+	FString signature;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "IngestBlock")
+	FString work;
+};
+
+USTRUCT(BlueprintType)
+struct NANO_API FIngestResponseData {
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "IngestResponse")
+	FString hash;
+
+	/** The stage which rejected the block, process once it is published */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "IngestResponse")
+	FIngestStage stage{FIngestStage::process};
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "IngestResponse")
+	FString errorMessage;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "IngestResponse")
+	bool error{false};
+};
+
+USTRUCT(BlueprintType)
+struct NANO_API FIngestStageMetrics {
+	GENERATED_USTRUCT_BODY()
+
+	/** Blocks waiting for or in this stage */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "IngestStageMetrics")
+	int32 queued{0};
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "IngestStageMetrics")
+	int32 passed{0};
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "IngestStageMetrics")
+	int32 rejected{0};
+
+	/** Mean time from entering the stage's queue to leaving the stage */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "IngestStageMetrics")
+	float averageLatencyMs{0.0f};
+};
+
+DECLARE_DYNAMIC_DELEGATE_OneParam(FIngestResponseReceivedDelegate, FIngestResponseData, data);
+
+/**
+ * Checks blocks handed to the server by clients and publishes the valid ones. Each block is decoded and hashed, then goes
+ * through batched signature verification on a worker thread, a work check, a batched frontier and balance lookup and finally
+ * process with a limited number of requests in flight. Blocks for the same account may be submitted back to back.
+ */
+UCLASS(BlueprintType, Blueprintable)
+class NANO_API UNanoBlockIngestor : public UObject {
+	GENERATED_BODY()
+
+public:
+	/** Used for the RPC requests */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NanoBlockIngestor", meta = (ExposeOnSpawn = true))
+	UNanoManager* manager;
+
+	/** Process requests in flight at once */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NanoBlockIngestor")
+	int32 maxConcurrentProcess{8};
+
+	/** Most accounts looked up by one accounts_balances/accounts_frontiers/blocks_info request */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NanoBlockIngestor")
+	int32 maxLookupBatch{256};
+
+	/** The delegate is called once the block is published or rejected */
+	UFUNCTION(BlueprintCallable, Category = "NanoBlockIngestor")
+	void Submit(FIngestResponseReceivedDelegate delegate, FIngestBlock block);
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "NanoBlockIngestor")
+	FIngestStageMetrics GetStageMetrics(FIngestStage stage) const;
+
+private:
+	/** Frontier and balances of an account, as the node has it or as the blocks accepted so far leave it */
+	struct AccountState {
+		nano::block_hash frontier{0};
+		nano::amount balance{0};
+		nano::amount pending{0};
+	};
+
+	struct Item {
+		FIngestResponseReceivedDelegate delegate;
+		nano::state_block block;
+		nano::block_hash hash;
+		nano::signature signature;
+		uint64_t work{0};
+		uint64_t difficulty{0};
+		double stageStart{0};
+		// The account before this block, put back if the node rejects it
+		AccountState before;
+	};
+
+	struct StageStats {
+		int32 passed{0};
+		int32 rejected{0};
+		double totalSeconds{0};
+	};
+
+	/** Blocks which passed the frontier check but haven't been processed yet, and the state they leave the account in */
+	struct AcceptedState {
+		AccountState state;
+		int32 unprocessed{0};
+	};
+
+	/** A batch of blocks being looked up, with the state of each account as the node has it */
+	struct LookupState {
+		TArray<Item> batch;
+		std::vector<nano::account> accounts;
+		nano::key_map<AccountState> states;
+	};
+
+	void Pass(Item& item, FIngestStage stage);
+	void Reject(Item& item, FIngestStage stage, FString const& message);
+
+	/** Returns true if a field is invalid */
+	bool Decode(FIngestBlock const& block, Item& item) const;
+
+	void QueueVerify(Item&& item);
+	void Verify();
+	void Lookup();
+	void LookupFrontiers(TSharedRef<LookupState> const& lookup);
+	/** The balance comes from the frontier block, so it always matches the frontier */
+	void LookupFrontierBlocks(TSharedRef<LookupState> const& lookup, std::vector<nano::block_hash> const& frontiers);
+	void FailLookup(LookupState& lookup);
+	void CheckFrontiers(LookupState& lookup);
+	/** Drops accepted states whose blocks have all been processed, once no lookup could have read the node's state before that */
+	void ForgetProcessed();
+	void Process();
+	void Processed(Item& item, bool error);
+
+	TArray<Item> verifyQueue;
+	int32 verifying{0};
+	TArray<Item> lookupQueue;
+	int32 lookingUp{0};
+	TArray<Item> processQueue;
+	int32 processing{0};
+	nano::key_map<int32> processingAccounts;	// accounts with a process request in flight, their blocks have to go in order
+	nano::key_map<AcceptedState> accepted;	  // checked ahead of the node's state, which lags until process returns
+	std::array<StageStats, 5> stats;
+};
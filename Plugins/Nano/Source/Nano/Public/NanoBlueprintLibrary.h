@@ -4,6 +4,7 @@
 #include "CoreMinimal.h"
 #include "Interfaces/IHttpRequest.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
+#include "NanoTypes.h"
 
 #include "NanoBlueprintLibrary.generated.h"
 
@@ -45,6 +46,59 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Nano")
 	static bool GreaterOrEqual(FString raw = "0", FString baseRaw = "0");
 
+	/** Zero if raw is not valid, check with ValidateRaw first if that matters */
+	UFUNCTION(BlueprintPure, Category = "Nano|Amount")
+	static FNanoAmount AmountFromRaw(const FString& raw);
+
+	/** Formats the amount as a raw string, only do this when the text is actually needed */
+	UFUNCTION(BlueprintPure, meta = (DisplayName = "To Raw (NanoAmount)", CompactNodeTitle = "->", BlueprintAutocast),
+		Category = "Nano|Amount")
+	static FString AmountToRaw(const FNanoAmount& amount);
+
+	/** Need to ensure there is no overflow! */
+	UFUNCTION(BlueprintPure, meta = (DisplayName = "NanoAmount + NanoAmount", CompactNodeTitle = "+"), Category = "Nano|Amount")
+	static FNanoAmount Add_AmountAmount(const FNanoAmount& a, const FNanoAmount& b);
+
+	/** Precondition that a is >= b */
+	UFUNCTION(BlueprintPure, meta = (DisplayName = "NanoAmount - NanoAmount", CompactNodeTitle = "-"), Category = "Nano|Amount")
+	static FNanoAmount Subtract_AmountAmount(const FNanoAmount& a, const FNanoAmount& b);
+
+	UFUNCTION(BlueprintPure, meta = (DisplayName = "Equal (NanoAmount)", CompactNodeTitle = "=="), Category = "Nano|Amount")
+	static bool EqualEqual_AmountAmount(const FNanoAmount& a, const FNanoAmount& b);
+
+	UFUNCTION(BlueprintPure, meta = (DisplayName = "NanoAmount > NanoAmount", CompactNodeTitle = ">"), Category = "Nano|Amount")
+	static bool Greater_AmountAmount(const FNanoAmount& a, const FNanoAmount& b);
+
+	UFUNCTION(BlueprintPure, meta = (DisplayName = "NanoAmount >= NanoAmount", CompactNodeTitle = ">="), Category = "Nano|Amount")
+	static bool GreaterEqual_AmountAmount(const FNanoAmount& a, const FNanoAmount& b);
+
+	UFUNCTION(BlueprintPure, meta = (DisplayName = "NanoAmount < NanoAmount", CompactNodeTitle = "<"), Category = "Nano|Amount")
+	static bool Less_AmountAmount(const FNanoAmount& a, const FNanoAmount& b);
+
+	UFUNCTION(BlueprintPure, meta = (DisplayName = "NanoAmount <= NanoAmount", CompactNodeTitle = "<="), Category = "Nano|Amount")
+	static bool LessEqual_AmountAmount(const FNanoAmount& a, const FNanoAmount& b);
+
+	/** Total of all the amounts, need to ensure there is no overflow! */
+	UFUNCTION(BlueprintPure, Category = "Nano|Amount")
+	static FNanoAmount SumAmounts(const TArray<FNanoAmount>& amounts);
+
+	/** Smallest of the amounts and its index, zero and -1 if there are none */
+	UFUNCTION(BlueprintPure, Category = "Nano|Amount")
+	static FNanoAmount MinAmount(const TArray<FNanoAmount>& amounts, int32& index);
+
+	/** Largest of the amounts and its index, zero and -1 if there are none */
+	UFUNCTION(BlueprintPure, Category = "Nano|Amount")
+	static FNanoAmount MaxAmount(const TArray<FNanoAmount>& amounts, int32& index);
+
+	/** True if work (16 hex digits) reaches difficulty (also hex) for this root, which is the previous block hash or the public key
+	 * for open blocks. The default difficulty is what sends need on the live network */
+	UFUNCTION(BlueprintCallable, Category = "Nano")
+	static bool ValidateWork(FString root, FString work, FString difficulty = "fffffff800000000");
+
+	/** ValidateWork for each pair of roots and works, which must be the same length */
+	UFUNCTION(BlueprintCallable, Category = "Nano")
+	static TArray<bool> ValidateWorkBatch(const TArray<FString>& roots, const TArray<FString>& works, FString difficulty = "fffffff800000000");
+
 	/** Create a cryptographically secure random number as a seed */
 	UFUNCTION(BlueprintCallable, Category = "Nano")
 	static FString CreateSeed();
@@ -61,6 +115,11 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Nano")
 	static FString AccountFromSeed(FString seed, int32 index);
 
+	/** Keys and accounts for count indices from start, derived across worker threads. Much faster than calling AccountFromSeed
+	 * for each index when scanning many. At most 1048576 (2^20) at a time. Empty if the seed or range is invalid */
+	UFUNCTION(BlueprintCallable, Category = "Nano")
+	static FSeedAccountsData AccountsFromSeedRange(FString seed, int32 start, int32 count);
+
 	/** Get the account from a hex public key */
 	UFUNCTION(BlueprintCallable, Category = "Nano")
 	static FString AccountFromPublicKey(FString publicKey);
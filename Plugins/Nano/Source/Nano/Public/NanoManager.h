@@ -4,31 +4,45 @@
 #include "Components/ActorComponent.h"
 #include "CoreMinimal.h"
 #include "Dom/JsonObject.h"
+#include "GenericPlatform/GenericPlatformFile.h"
 #include "GenericPlatform/GenericPlatformMisc.h"
 #include "Http.h"
 #include "NanoTypes.h"
 #include "NanoWebsocket.h"
 
+#include <nano/account_cache.h>
+#include <nano/key_map.h>
+#include <nano/keyring.h>
+#include <nano/numbers.h>
+#include <nano/pending_parser.h>
+#include <nano/rpc_writer.h>
+#include <nano/work.h>
+#include <nano/work_cache.h>
+
+#include <array>
 #include <chrono>
 #include <functional>
-#include <string>
-#include <unordered_map>
 
 #include "NanoManager.generated.h"
 
 class PrvKeyAutomateDelegate {
 public:
 	PrvKeyAutomateDelegate() = default;
-	PrvKeyAutomateDelegate(const FString& prvKey, const FAutomateResponseReceivedDelegate& delegate, const FString& minimum)
-		: prvKey(prvKey), delegate(delegate), minimum(minimum) {
+	PrvKeyAutomateDelegate(
+		nano::keyring::handle key, const FAutomateResponseReceivedDelegate& delegate, const FString& minimum)
+		: key(key), delegate(delegate), minimum(minimum), minimumValue(FNanoAmount::FromRaw(minimum)) {
 	}
 
 	PrvKeyAutomateDelegate(const PrvKeyAutomateDelegate&) = delete;
 	PrvKeyAutomateDelegate& operator=(const PrvKeyAutomateDelegate&) = delete;
+	PrvKeyAutomateDelegate(PrvKeyAutomateDelegate&&) = default;
+	PrvKeyAutomateDelegate& operator=(PrvKeyAutomateDelegate&&) = default;
 
-	FString prvKey;
+	// Held in the manager's keyring until unregistered
+	nano::keyring::handle key{nano::keyring::invalid};
 	FAutomateResponseReceivedDelegate delegate;
 	FString minimum;
+	FNanoAmount minimumValue;
 	FTimerHandle timerHandle;
 };
 
@@ -42,16 +56,28 @@ public:
 
 	BlockListenerDelegate(const BlockListenerDelegate&) = delete;
 	BlockListenerDelegate& operator=(const BlockListenerDelegate&) = delete;
+	BlockListenerDelegate(BlockListenerDelegate&&) = default;
+	BlockListenerDelegate& operator=(BlockListenerDelegate&&) = default;
 
 	ResponseReceiveDelegate delegate;
 	ResponseData data;
 	FTimerHandle timerHandle;
+	// When the block was last published, for republishing it if it isn't confirmed in time
+	std::chrono::steady_clock::time_point published{std::chrono::steady_clock::now()};
+};
+
+// Work for the next block of an account, generated in the background once its frontier is known
+struct PrecachedWork {
+	nano::block_hash root{};
+	uint64_t work{0};
+	bool ready{false};
 };
 
 struct ListeningPayment {
 	FListenPaymentDelegate delegate;
 	FString account;
 	FString amount;
+	FNanoAmount amountValue;
 	int32 watchId;
 	FTimerHandle timerHandle;
 };
@@ -74,9 +100,18 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "NanoManager")
 	void GetWalletBalance(FGetBalanceResponseReceivedDelegate delegate, FString address);
 
-	/** Generate work for this block hash */
+	/** Generate work for this block hash, on this machine's CPU if localWork is set, otherwise by the RPC server. Receive and
+	 * open blocks need much less work than the rest */
 	UFUNCTION(BlueprintCallable, Category = "NanoManager")
-	void WorkGenerate(FWorkGenerateResponseReceivedDelegate delegate, FString hash);
+	void WorkGenerate(FWorkGenerateResponseReceivedDelegate delegate, FString hash, FSubtype subtype = FSubtype::send);
+
+	/** Stops generating local work for this hash, the delegate is called with an error */
+	UFUNCTION(BlueprintCallable, Category = "NanoManager")
+	void CancelWorkGenerate(FString hash);
+
+	/** Total nonces tried by the local work generator, poll it to show progress */
+	UFUNCTION(BlueprintCallable, Category = "NanoManager")
+	int64 GetLocalWorkAttempts() const;
 
 	/** Process this block */
 	UFUNCTION(BlueprintCallable, Category = "NanoManager")
@@ -178,6 +213,47 @@ public:
 	void Receive(
 		const FProcessResponseReceivedDelegate& delegate, FString const& privateKey, FString sourceHash, FString const& amount);
 
+	/**
+	 * Decodes a private key and derives its account once, the *WithKey functions use them instead of doing this on every call.
+	 * Registering the same key again adds a reference and each needs an UnregisterKey. Invalid keys give a key nothing accepts
+	 */
+	UFUNCTION(BlueprintCallable, Category = "NanoManager")
+	FNanoKey RegisterKey(FString const& privateKey);
+
+	/** Calls already using the key still finish */
+	UFUNCTION(BlueprintCallable, Category = "NanoManager")
+	void UnregisterKey(FNanoKey key);
+
+	/** Empty if the key isn't registered */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "NanoManager")
+	FString GetKeyAccount(FNanoKey key) const;
+
+	/** Send with a registered key */
+	UFUNCTION(BlueprintCallable, Category = "NanoManager")
+	void SendWithKey(FProcessResponseReceivedDelegate delegate, FNanoKey key, FString const& account, FString const& amount);
+
+	/** SendWaitConfirmation with a registered key */
+	UFUNCTION(BlueprintCallable, Category = "NanoManager")
+	void SendWaitConfirmationWithKey(
+		FProcessResponseReceivedDelegate delegate, FNanoKey key, FString const& account, FString const& amount);
+
+	/** AutomaticallyPocketRegister with a registered key, which stays registered until AutomaticallyPocketUnregister */
+	UFUNCTION(BlueprintCallable, Category = "NanoManager")
+	void AutomaticallyPocketRegisterWithKey(
+		FAutomateResponseReceivedDelegate delegate, UNanoWebsocket* websocket, FNanoKey key, FString minimum = "0");
+
+	/** MakeSendBlock with a registered key */
+	UFUNCTION(BlueprintCallable, Category = "NanoManager")
+	void MakeSendBlockWithKey(FMakeBlockDelegate delegate, FNanoKey key, FString const& amount, FString const& destinationAccount);
+
+	/** MakeReceiveBlock with a registered key */
+	UFUNCTION(BlueprintCallable, Category = "NanoManager")
+	void MakeReceiveBlockWithKey(FMakeBlockDelegate delegate, FNanoKey key, FString sourceHash, FString const& amount);
+
+	/** Receive with a registered key */
+	UFUNCTION(BlueprintCallable, Category = "NanoManager", meta = (AutoCreateRefTerm = "delegate"))
+	void ReceiveWithKey(const FProcessResponseReceivedDelegate& delegate, FNanoKey key, FString sourceHash, FString const& amount);
+
 	UFUNCTION(BlueprintCallable, Category = "NanoManager")
 	void SetDataSubdirectory(FString const& subdir);
 
@@ -199,86 +275,281 @@ public:
 	UPROPERTY(EditAnywhere, Category = "NanoManager")
 	FString defaultRepresentative{"nano_1iuz18n4g4wfp9gf7p1s8qkygxw7wx9qfjq6a9aq68uyrdnningdcjontgar"};
 
+	/** Generate work on this machine instead of asking the RPC server for it */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NanoManager")
+	bool localWork{false};
+
+	/** Threads used for local work, 0 leaves one hardware thread free. Read when local work is first generated */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NanoManager")
+	int32 localWorkThreads{0};
+
+	/** Generate work for the next block of an account as soon as its new frontier is known, so sends and receives can skip it */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NanoManager")
+	bool precacheWork{false};
+
+	/** Keep precached work in a file under the data path so it survives restarts, nothing is written unless precacheWork is set */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NanoManager")
+	bool persistWorkCache{true};
+
+	/** Blocks made with precached work */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "NanoManager")
+	int32 workCacheHits{0};
+
+	/** Blocks which had to wait for work while precaching was enabled */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "NanoManager")
+	int32 workCacheMisses{0};
+
+	/** Sample the network's active difficulty and generate work at its multiplier, so blocks still confirm quickly when the
+	 * network is saturated. Blocks waited on which stay unconfirmed are republished with more work */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NanoManager")
+	bool dynamicWorkDifficulty{false};
+
+	/** Seconds between active_difficulty requests, read when sampling starts */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NanoManager")
+	float activeDifficultyInterval{20.0f};
+
+	/** Work is never generated above this multiplier of the subtype's threshold, however busy the network is */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NanoManager")
+	float maxWorkMultiplier{16.0f};
+
+	/** Seconds a block waited on can stay unconfirmed before it is republished with double the work, 0 to never republish */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NanoManager")
+	float republishTimeout{30.0f};
+
+	/** The last multiplier sampled from the network */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "NanoManager")
+	float activeMultiplier{1.0f};
+
+	/** RPC requests sent to the server */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "NanoManager")
+	int32 rpcRequestsSent{0};
+
+	/** Requests which were identical to one already in flight and shared its response instead of being sent */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "NanoManager")
+	int32 rpcRequestsCoalesced{0};
+
+	/** The fraction of requests answered by one already in flight */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "NanoManager")
+	float GetRpcCoalescedRatio() const;
+
+	/** Seconds balance, frontier, pending and block confirmation requests wait so those for different accounts or hashes can be
+	 * sent together as one accounts_* or blocks_info request. 0, the default, sends each on its own. The node or proxy has to
+	 * allow accounts_balances, accounts_frontiers, accounts_pending and blocks_info */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NanoManager")
+	float rpcBatchWindow{0.0f};
+
+	/** A batch is sent as soon as it has this many requests, without waiting for the rest of the window */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NanoManager")
+	int32 rpcMaxBatch{100};
+
+	/** Per-account requests answered from a batch response, not counting those which had to be sent again on their own */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "NanoManager")
+	int32 rpcRequestsBatched{0};
+
 private:
-	std::unordered_map<std::string, PrvKeyAutomateDelegate> keyDelegateMap;
-	TMap<FString, TMap<int32, FWatchAccountReceivedDelegate>> watchers;
+	// Makes its requests through this manager
+	friend class UNanoBlockIngestor;
+
+	// Registries are keyed by the binary account, or block hash for the block listeners
+	nano::key_map<PrvKeyAutomateDelegate> keyDelegateMap;
+	nano::key_map<TMap<int32, FWatchAccountReceivedDelegate>> watchers;
 	int32 watcherId{0};
-	std::unordered_map<std::string, BlockListenerDelegate<FProcessResponseData, FProcessResponseReceivedDelegate>> sendBlockListener;
-	std::unordered_map<std::string, BlockListenerDelegate<FAutomateResponseData, FAutomateResponseReceivedDelegate>>
-		receiveBlockListener;
+	nano::key_map<BlockListenerDelegate<FProcessResponseData, FProcessResponseReceivedDelegate>> sendBlockListener;
+	nano::key_map<BlockListenerDelegate<FAutomateResponseData, FAutomateResponseReceivedDelegate>> receiveBlockListener;
+	nano::account_cache accounts;
+	nano::keyring keys;
 	ListeningPayment listeningPayment;
 	ListeningPayout listeningPayout;
 
-	struct ReqRespJson {
-		TSharedPtr<FJsonObject> request;
-		TSharedPtr<FJsonObject> response;
-	};
+	/** The response body parsed once, null if the request failed, the status isn't OK or the body isn't json */
+	static TSharedPtr<FJsonObject> ParseResponse(FHttpResponsePtr response, bool wasSuccessful);
+
+	/**
+	 * The delegate gets the parsed response. The request isn't parsed back, anything from it the response data needs (the account,
+	 * hash) is captured by the delegate and passed to the Get*ResponseData function along with the response
+	 */
+	void MakeRequest(TSharedPtr<FJsonObject> JsonObject, TFunction<void(TSharedPtr<FJsonObject> const& response)> delegate);
+	/**
+	 * Sends json already written as UTF-8, usually requestContent. Only for idempotent requests: one identical to a request
+	 * still in flight isn't sent, its delegate waits for that response instead. Use SendRequest for process
+	 */
+	void MakeRequest(TArray<uint8> const& content, TFunction<void(TSharedPtr<FJsonObject> const& response)> delegate);
 
-	static ReqRespJson GetResponseJson(FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful);
-	static bool RequestResponseIsValid(FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful);
+	/** For responses read by a streaming parser, the delegate gets the body unparsed. It is empty if the request failed */
+	void MakeRawRequest(TArray<uint8> const& content, TFunction<void(TArray<uint8> const& response)> delegate);
 
-	void MakeRequest(TSharedPtr<FJsonObject> JsonObject,
-		TFunction<void(FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful)> delegate);
+	/** Always sends, for requests which change something */
+	void SendRequest(TArray<uint8> const& content, TFunction<void(TSharedPtr<FJsonObject> const& response)> delegate);
+	void SendRequest(TSharedRef<IHttpRequest> const& HttpRequest, TFunction<void(TSharedPtr<FJsonObject> const& response)> delegate);
 
+	/** Delegates waiting on a request, keyed by the blake2b hash of its body */
+	struct InFlightRequest {
+		TArray<TFunction<void(TSharedPtr<FJsonObject> const& response)>> delegates;
+		TArray<TFunction<void(TArray<uint8> const& response)>> rawDelegates;
+	};
+	nano::key_map<InFlightRequest> inFlightRequests;
+
+	enum class RpcBatchKind : uint8 { balance, frontier, pending, blockInfo };
+
+	/** A request for one account or hash, text is how the caller gave it and key the decoded value */
+	struct BatchedRequest {
+		nano::uint256_union key;
+		FString text;
+		TFunction<void(TSharedPtr<FJsonObject> const& response)> delegate;
+		TFunction<void(TArray<uint8> const& response)> rawDelegate;
+		// Pending requests only batch with others for the same count and threshold
+		int32 count{0};
+		FString threshold;
+	};
+	struct RequestBatch {
+		RpcBatchKind kind;
+		TArray<BatchedRequest> requests;
+		FTimerHandle timer;
+	};
+	TMap<FString, TSharedPtr<RequestBatch>> requestBatches;
+
+	/** Adds the request to the open batch of its kind, or sends it straight away if batching is off or its key is invalid */
+	void QueueRequest(RpcBatchKind kind, BatchedRequest request);
+	void FlushBatch(FString const& name);
+	void SendUnbatched(RpcBatchKind kind, BatchedRequest const& request);
+	/**
+	 * Hands each request its own entry of the batch response, in the shape the single request returns. Requests the response
+	 * has nothing for, or all of them if the node rejected the batch, are sent on their own
+	 */
+	void FanOutBatch(RequestBatch const& batch, TSharedPtr<FJsonObject> const& response, TCHAR const* field);
+	/**
+	 * account_info is put back together from accounts_frontiers and then blocks_info on those frontiers. Each block carries its
+	 * balance and representative, so they always match the frontier
+	 */
+	void LookupFrontierBlocks(TSharedPtr<RequestBatch> const& batch, TSharedPtr<FJsonObject> const& frontiers);
+	void FanOutFrontiers(
+		RequestBatch const& batch, TSharedPtr<FJsonObject> const& frontiers, TSharedPtr<FJsonObject> const& blocks);
+	void FanOutPending(RequestBatch const& batch, TArray<uint8> const& response);
+	/** The entries of an accounts_* or blocks_info result by binary account or hash */
+	nano::key_map<TSharedPtr<FJsonValue>> ResultsByKey(TSharedPtr<FJsonObject> const& response, TCHAR const* field, bool hashes);
+
+	/** Returns the entry to wait on, first is true if the caller has to send the request after adding its delegate */
+	std::pair<InFlightRequest*, bool> JoinRequest(TArray<uint8> const& content, nano::uint256_union& key);
+	void SendJoinedRequest(TArray<uint8> const& content, nano::uint256_union const& key);
+	/** Parses the response once for all the json delegates */
+	void CompleteRequest(nano::uint256_union const& key, FHttpResponsePtr response, bool wasSuccessful);
+	TSharedRef<IHttpRequest> CreateHttpRequest();
 	TSharedRef<IHttpRequest> CreateHttpRequest(TSharedPtr<FJsonObject> JsonObject);
+	TSharedRef<IHttpRequest> CreateHttpRequest(TArray<uint8> const& content);
+
+	struct RequestSink {
+		TArray<uint8>* content;
+		void operator()(char const* data, size_t size) const {
+			content->Append(reinterpret_cast<uint8 const*>(data), static_cast<int32>(size));
+		}
+	};
+
+	/**
+	 * Clears requestContent and returns a writer for it. The frequent requests are written by the schemas in nano/rpc_writer.h
+	 * rather than converted from their USTRUCT, which saves the reflection, the json DOM and the UTF-16 round trip
+	 */
+	nano::json_writer<RequestSink> RequestWriter();
+	TArray<uint8> requestContent;
+
+	FAccountFrontierResponseData GetAccountFrontierResponseData(TSharedPtr<FJsonObject> const& response, FString const& account) const;
+
+	void AccountFrontier(FString account, TFunction<void(TSharedPtr<FJsonObject> const& response)> const& d);
+
+	static FWorkGenerateResponseData GetWorkGenerateResponseData(TSharedPtr<FJsonObject> const& response, FString const& hash);
 
-	TSharedPtr<FJsonObject> GetAccountFrontierJsonObject(FString const& account);
-	FAccountFrontierResponseData GetAccountFrontierResponseData(
-		FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful) const;
+	void WorkGenerate(FString hash, uint64_t threshold, TFunction<void(FWorkGenerateResponseData const&)> const& delegate);
 
-	void AccountFrontier(
-		FString account, TFunction<void(FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful)> const& d);
+	/** Threshold for this subtype at the active multiplier, starts sampling the active difficulty on first use */
+	uint64_t WorkThreshold(FSubtype subtype);
+	void SampleActiveDifficulty();
+	static FActiveDifficultyResponseData GetActiveDifficultyResponseData(TSharedPtr<FJsonObject> const& response);
+	FTimerHandle activeDifficultyTimerHandle;
 
-	TSharedPtr<FJsonObject> GetWorkGenerateJsonObject(FString hash);
-	static FWorkGenerateResponseData GetWorkGenerateResponseData(
-		FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful);
+	/** Processes the block from this block_info response again, with more work if the multiplier allows */
+	void Republish(TSharedPtr<FJsonObject> const& response);
 
-	void WorkGenerate(FString hash, TFunction<void(FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful)> const& d);
+	/** Created on first use so localWorkThreads can be set beforehand */
+	nano::work_pool& GetWorkPool();
+	TUniquePtr<nano::work_pool> workPool;
 
-	void Send(FString const& privateKey, FString const& account, FString const& amount,
+	/** Starts generating work for the block after root if precacheWork is set */
+	void PrecacheWork(nano::account const& account, FString const& root);
+
+	/** Uses the account's precached work if it is for this root, otherwise the same as WorkGenerate */
+	void CachedWorkGenerate(nano::account const& account, FString const& root, FSubtype subtype,
+		TFunction<void(FWorkGenerateResponseData const&)> const& delegate);
+	nano::key_map<PrecachedWork> precachedWork;
+
+	/** The persistent work cache, loaded from the data path on first use */
+	nano::work_cache& GetWorkCache();
+	FString GetWorkCachePath() const;
+	void RewriteWorkCache();
+	void AppendWorkCache(nano::work_cache::record const& record);
+	void RememberWork(nano::block_hash const& root, uint64_t work);
+	void ForgetWork(nano::block_hash const& root);
+	nano::work_cache workCache;
+	bool workCacheLoaded{false};
+	TUniquePtr<IFileHandle> workCacheFile;
+
+	/**
+	 * Every call holds a reference to its key, so unregistering it part way through is safe. Calls given a private key string
+	 * register it for their duration. Returns invalid if the key doesn't decode or isn't registered
+	 */
+	nano::keyring::handle AcquireKey(FString const& privateKey);
+	nano::keyring::handle AcquireKey(FNanoKey key);
+
+	// Those taking a TFunction leave releasing the key to the caller, the others release it once they are done with it
+	void Send(nano::keyring::handle key, FString const& account, FString const& amount,
 		TFunction<void(FProcessResponseData)> const& delegate);
+	void SendWaitConfirmation(
+		nano::keyring::handle key, FString const& account, FString const& amount, FProcessResponseReceivedDelegate delegate);
+	/** Keeps the key until AutomaticallyPocketUnregister */
+	void AutomaticallyPocketRegister(
+		FAutomateResponseReceivedDelegate delegate, UNanoWebsocket* websocket, nano::keyring::handle key, FString const& minimum);
+	void Receive(nano::keyring::handle key, FString sourceHash, FString const& amount, FProcessResponseReceivedDelegate delegate);
 
 	template <class T, class T1>
-	void RegisterBlockListener(std::string const& account, T const& responseData,
-		std::unordered_map<std::string, BlockListenerDelegate<T, T1>>& blockListener, T1 delegate);
+	void RegisterBlockListener(nano::account const& account, T const& responseData,
+		nano::key_map<BlockListenerDelegate<T, T1>>& blockListener, T1 delegate);
 
-	void MakeSendBlock(FString const& prvKey, FString const& amount, FString const& destinationAccount,
+	/** Conversions go through the account cache, DecodeAccount returns true on error */
+	bool DecodeAccount(FString const& account, nano::account& key);
+	FString EncodeAccount(nano::account const& key);
+
+	void MakeSendBlock(nano::keyring::handle key, FString const& amount, FString const& destinationAccount,
 		TFunction<void(FMakeBlockResponseData)> const& delegate);
 
 	int32 Watch(FString const& account, UNanoWebsocket* websocket);
 
-	TSharedPtr<FJsonObject> GetPendingJsonObject(FString account, FString threshold, int32 maxCount);
-	static FPendingResponseData GetPendingResponseData(FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful);
-	static FGetBalanceResponseData GetBalanceResponseData(FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful);
-	static FProcessResponseData GetProcessResponseData(FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful);
-	static FRequestNanoResponseData GetRequestNanoData(FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful);
+	FPendingResponseData GetPendingResponseData(TArray<uint8> const& response, FString const& account);
+	static FGetBalanceResponseData GetBalanceResponseData(TSharedPtr<FJsonObject> const& response, FString const& account);
+	static FProcessResponseData GetProcessResponseData(TSharedPtr<FJsonObject> const& response);
+	static FRequestNanoResponseData GetRequestNanoData(TSharedPtr<FJsonObject> const& response, FString const& account);
 
-	void GetWalletBalance(
-		FString address, TFunction<void(FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful)> const& delegate);
+	void GetWalletBalance(FString address, TFunction<void(TSharedPtr<FJsonObject> const& response)> const& delegate);
 
-	void BlockConfirmed(
-		FString hash, TFunction<void(FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful)> const& d);
-	TSharedPtr<FJsonObject> GetBlockConfirmedJsonObject(FString const& hash);
-	static FBlockConfirmedResponseData GetBlockConfirmedResponseData(
-		FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful);
+	void BlockConfirmed(FString hash, TFunction<void(TSharedPtr<FJsonObject> const& response)> const& d);
+	static FBlockConfirmedResponseData GetBlockConfirmedResponseData(TSharedPtr<FJsonObject> const& response);
 
-	void Pending(FString account, FString threshold, int32 maxCount,
-		TFunction<void(FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful)> const& d);
+	void Pending(FString account, FString threshold, int32 maxCount, TFunction<void(TArray<uint8> const& response)> const& d);
+	/** Reused between pending responses, which are read straight into it by nano::parse_pending */
+	std::vector<nano::pending_entry> pendingEntries;
 
-	void Process(
-		FBlock block, TFunction<void(FHttpRequestPtr request, FHttpResponsePtr response, bool wasSuccessful)> const& delegate);
+	void Process(FBlock block, TFunction<void(TSharedPtr<FJsonObject> const& response)> const& delegate);
+	/** Signs with this key rather than the block's privateKey */
+	void Process(FBlock const& block, nano::keyring::entry const& key, TFunction<void(TSharedPtr<FJsonObject> const& response)> const& delegate);
 
 	void AutomateWorkGenerateLoop(FAccountFrontierResponseData frontierData, TArray<FPendingBlock> pendingBlocks);
-	void AutomatePocketPendingUtility(const FString& account, const FString& minimum);
+	void AutomatePocketPendingUtility(nano::account const& account, const FString& minimum);
 
-	void GetFrontierAndFire(const FString& amount, const FString& hash, FString const& account, FConfType type);
+	void GetFrontierAndFire(const FString& amount, const FString& hash, nano::account const& account, FConfType type);
 
-	void GetFrontierAndFireWatchers(const FString& amount, const FString& hash, FString const& account, FConfType type);
+	void GetFrontierAndFireWatchers(const FString& amount, const FString& hash, nano::account const& account, FConfType type);
 	FAutomateResponseData GetWebsocketResponseData(const FString& amount, const FString& hash, FString const& account, FConfType type,
 		FAccountFrontierResponseData const& frontierData);
 
-	void MakeReceiveBlock(
-		FString const& privateKey, FString sourceHash, FString const& amount, TFunction<void(FMakeBlockResponseData)> const& delegate);
+	void MakeReceiveBlock(nano::keyring::handle key, FString sourceHash, FString const& amount,
+		TFunction<void(FMakeBlockResponseData)> const& delegate);
 
 	UFUNCTION()
 	void OnConfirmationReceiveMessage(const FWebsocketConfirmationResponseData& data, UNanoWebsocket* websocket);
@@ -1,11 +1,102 @@
 // Copyright 2020 Wesley Shillingford. All rights reserved.
 #pragma once
 
+#include "CoreMinimal.h"
+
 #include "NanoTypes.generated.h"
 
 UENUM(BlueprintType)
 enum class FConfType : uint8 { send_to, send_from, receive };
 
+/**
+ * A raw amount held as a native 128-bit number, so comparing two is at most two 64-bit compares. The decimal string is only
+ * formatted when asked for with ToRaw. Use the UNanoBlueprintLibrary amount nodes from Blueprint.
+ */
+USTRUCT(BlueprintType)
+struct NANO_API FNanoAmount {
+	GENERATED_USTRUCT_BODY()
+
+	FNanoAmount() = default;
+	FNanoAmount(uint64 high, uint64 low) : high(high), low(low) {
+	}
+
+	/** Zero if raw is not a valid amount */
+	static FNanoAmount FromRaw(const FString& raw);
+
+	/** Returns true on error, amount is left untouched */
+	static bool FromRaw(const FString& raw, FNanoAmount& amount);
+
+	FString ToRaw() const;
+
+	bool IsZero() const {
+		return (high | low) == 0;
+	}
+
+	bool operator==(const FNanoAmount& other) const {
+		return high == other.high && low == other.low;
+	}
+	bool operator!=(const FNanoAmount& other) const {
+		return !(*this == other);
+	}
+	bool operator<(const FNanoAmount& other) const {
+		return high != other.high ? high < other.high : low < other.low;
+	}
+	bool operator>(const FNanoAmount& other) const {
+		return other < *this;
+	}
+	bool operator<=(const FNanoAmount& other) const {
+		return !(other < *this);
+	}
+	bool operator>=(const FNanoAmount& other) const {
+		return !(*this < other);
+	}
+
+	/** Wraps on overflow */
+	FNanoAmount operator+(const FNanoAmount& other) const {
+		auto sum = low + other.low;
+		return FNanoAmount(high + other.high + (sum < low ? 1 : 0), sum);
+	}
+
+	/** Wraps on underflow */
+	FNanoAmount operator-(const FNanoAmount& other) const {
+		return FNanoAmount(high - other.high - (low < other.low ? 1 : 0), low - other.low);
+	}
+
+	UPROPERTY()
+	uint64 high{0};
+
+	UPROPERTY()
+	uint64 low{0};
+};
+
+/** Keys of consecutive seed indices, element i of each array belongs to index start + i */
+USTRUCT(BlueprintType)
+struct NANO_API FSeedAccountsData {
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "SeedAccounts")
+	int32 start{0};
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "SeedAccounts")
+	TArray<FString> privateKeys;
+
+	/** As hex */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "SeedAccounts")
+	TArray<FString> publicKeys;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "SeedAccounts")
+	TArray<FString> accounts;
+};
+
+/** A private key registered with UNanoManager::RegisterKey. Pass it to the *WithKey functions instead of the key's string */
+USTRUCT(BlueprintType)
+struct NANO_API FNanoKey {
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY()
+	uint32 handle{0};
+};
+
 // IMPORTANT, all *RequestData objects must match the json keys on the server, which is why they underscores instead of lower camel
 // case like the rest of the codebase.
 
@@ -36,6 +127,12 @@ struct NANO_API FGetBalanceResponseData {
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "GetBalance")
 	FString pending;
 
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "GetBalance")
+	FNanoAmount balanceValue;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "GetBalance")
+	FNanoAmount pendingValue;
+
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "GetBalance")
 	bool error{false};
 };
@@ -47,6 +144,9 @@ struct NANO_API FWorkGenerateRequestData {
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "WorkGenerate")
 	FString hash;
 
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "WorkGenerate")
+	FString difficulty;
+
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "WorkGenerate")
 	FString action{"work_generate"};
 };
@@ -61,6 +161,14 @@ struct NANO_API FWorkGenerateResponseData {
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "WorkGenerate")
 	FString work;
 
+	/** What the work actually reached, which can be more than was asked for */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "WorkGenerate")
+	FString difficulty;
+
+	/** Difficulty relative to the send threshold, receives only need 1/64 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "WorkGenerate")
+	float multiplier{0.0f};
+
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "WorkGenerate")
 	bool error{false};
 };
@@ -101,6 +209,9 @@ struct NANO_API FAccountFrontierResponseData {
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "AccountFrontier")
 	FString representative;
 
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "AccountFrontier")
+	FNanoAmount balanceValue;
+
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "AccountFrontier")
 	bool error{false};
 };
@@ -143,6 +254,9 @@ struct NANO_API FPendingBlock {
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "PendingBlock")
 	FString source;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "PendingBlock")
+	FNanoAmount amountValue;
 };
 
 USTRUCT(BlueprintType)
@@ -159,6 +273,26 @@ struct NANO_API FPendingResponseData {
 	bool error{false};
 };
 
+USTRUCT(BlueprintType)
+struct NANO_API FActiveDifficultyRequestData {
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "ActiveDifficulty")
+	FString action{"active_difficulty"};
+};
+
+USTRUCT(BlueprintType)
+struct NANO_API FActiveDifficultyResponseData {
+	GENERATED_USTRUCT_BODY()
+
+	/** How much more work than the base threshold the network currently wants */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "ActiveDifficulty")
+	float multiplier{1.0f};
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "ActiveDifficulty")
+	bool error{false};
+};
+
 USTRUCT(BlueprintType)
 struct NANO_API FBlockConfirmedResponseData {
 	GENERATED_USTRUCT_BODY()
@@ -330,6 +464,12 @@ struct NANO_API FAutomateResponseData {
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Automate")
 	FString representative;
 
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Automate")
+	FNanoAmount amountValue;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Automate")
+	FNanoAmount balanceValue;
+
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Automate")
 	bool error{false};
 };
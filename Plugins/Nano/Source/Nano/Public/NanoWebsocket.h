@@ -5,6 +5,10 @@
 #include "CoreMinimal.h"
 #include "IWebSocket.h"
 #include "Http.h"
+#include "NanoTypes.h"
+
+#include <nano/account_cache.h>
+#include <nano/key_map.h>
 
 #include "NanoWebsocket.generated.h"
 
@@ -47,6 +51,9 @@ struct NANO_API FWebsocketBlock {
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Block")
 	FString work;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Block")
+	FString signature;
 };
 
 USTRUCT(BlueprintType)
@@ -62,6 +69,9 @@ struct NANO_API FWebsocketConfirmationResponseData {
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "WebsocketConfirmationResponse")
 	FString hash;
 
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "WebsocketConfirmationResponse")
+	FNanoAmount amountValue;
+
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "WebsocketConfirmationResponse")
 	FWebsocketBlock block;
 };
@@ -111,16 +121,46 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "UNanoWebsocket")
 	void UnlistenAll();
 
+	/** Check the signature of each confirmation against its block before broadcasting it, rather than trusting the websocket
+	 * server. They are verified in batches on a worker thread, which is cheap enough even when listening to all */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "UNanoWebsocket")
+	bool verifySignatures{false};
+
+	/** Confirmations dropped because their block or signature was invalid */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "UNanoWebsocket")
+	int32 rejectedConfirmations{0};
+
 protected:
 	void BeginDestroy() override;
 
 private:
+	/** Conversions go through the account cache, DecodeAccount returns true on error */
+	bool DecodeAccount(FString const& account, nano::account& key);
+	FString EncodeAccount(nano::account const& key);
+
+	void Broadcast(FWebsocketConfirmationResponseData const& data, bool isFiltered);
+
+	struct PendingConfirmation {
+		FWebsocketConfirmationResponseData data;
+		bool isFiltered;
+		nano::block_hash hash;
+		nano::account account;
+		nano::signature signature;
+	};
+
+	/** Decodes and hashes the block here, then leaves the signature for the next batch */
+	void QueueVerification(FWebsocketConfirmationResponseData const& data, bool isFiltered);
+	/** Verifies everything queued on a worker thread, one batch is in flight at a time so confirmations stay in order */
+	void VerifyPending();
+	TArray<PendingConfirmation> pendingVerification;
+	bool verifying{false};
+
 	TSharedPtr<IWebSocket> Websocket;
 	FTimerHandle timerHandle;
 
 	bool isReconnection{false};
 	bool isListeningAll{false};
 
-	// TODO: Should use nano::account
-	TMap<FString, int> registeredAccounts;	// account and number of times it was registered
+	nano::key_map<int> registeredAccounts;	// account and number of times it was registered
+	nano::account_cache accounts;
 };
@@ -0,0 +1,51 @@
+// Copyright 2020 Wesley Shillingford. All rights reserved.
+#pragma once
+
+#include <nano/key_map.h>
+#include <nano/numbers.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace nano
+{
+/**
+ * Least recently used cache of account <-> nano_ string conversions. Both directions need a blake2b checksum, accounts
+ * which were converted recently skip it and come straight out of the cache. Not thread safe.
+ */
+class account_cache final
+{
+public:
+	explicit account_cache (size_t capacity_a = 1024);
+	/** Same as uint256_union::decode_account, true on error */
+	bool decode (char const * text_a, size_t length_a, nano::account & account_a);
+	void encode (nano::account const & account_a, std::array<char, 65> & text_a);
+	size_t size () const;
+	uint64_t hits{ 0 };
+	uint64_t misses{ 0 };
+
+private:
+	/** The 60 characters after the prefix, shared by nano_ and xrb_ */
+	using body = std::array<char, 60>;
+	class entry final
+	{
+	public:
+		nano::account account;
+		body text;
+		uint32_t newer;
+		uint32_t older;
+	};
+	static nano::uint256_union text_key (char const *);
+	void insert (nano::account const &, char const *);
+	void touch (uint32_t);
+	void unlink (uint32_t);
+	std::vector<entry> entries;
+	nano::key_map<uint32_t> by_account;
+	nano::key_map<uint32_t> by_text;
+	size_t capacity;
+	uint32_t newest;
+	uint32_t oldest;
+};
+}
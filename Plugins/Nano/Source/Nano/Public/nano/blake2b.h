@@ -0,0 +1,33 @@
+// Copyright 2020 Wesley Shillingford. All rights reserved.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace nano
+{
+/**
+ * BLAKE2b compression kernels. blake2b_update/final in blake2b-ref.cpp compress through the selected one, so block hashes,
+ * account checksums, key derivation and ed25519 all use it. The SIMD kernels hold a row of the state per register (two with
+ * SSE4.1) and run the 4 column or diagonal G functions of a round together.
+ */
+enum class blake2b_kernel
+{
+	scalar,
+	sse41,
+	avx2
+};
+
+/** Widest kernel this cpu supports, which is selected until something else is */
+nano::blake2b_kernel best_blake2b_kernel ();
+NANO_API nano::blake2b_kernel blake2b_selected ();
+/** Returns true if the cpu doesn't support the kernel, leaving the selection unchanged */
+NANO_API bool blake2b_select (nano::blake2b_kernel kernel_a);
+
+/**
+ * Unkeyed blake2b of count_a messages which are all inlen_a bytes long, out_a[i] is the outlen_a byte digest of in_a[i].
+ * With AVX2 4 messages are hashed at once, one per 64-bit lane, otherwise they go through blake2b one at a time. Meant for
+ * the short messages of batches of keys, checksums and block hashes.
+ */
+NANO_API void blake2b_many (uint8_t * const * out_a, size_t outlen_a, uint8_t const * const * in_a, size_t inlen_a, size_t count_a);
+}
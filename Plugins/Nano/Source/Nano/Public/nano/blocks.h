@@ -3,10 +3,9 @@
 
 #include <nano/numbers.h>
 
-#ifdef _WIN32
-#pragma warning (disable : 4804 ) /* '/': unsafe use of type 'bool' in operation warnings */
-#endif
-#include <blake2/blake2.h>
+/** Declared in blake2/blake2.h, which stays private to the module */
+struct blake2b_state__;
+typedef struct blake2b_state__ blake2b_state;
 
 namespace nano
 {
@@ -24,7 +23,7 @@ public:
 	nano::uint256_union link;
 };
 
-class state_block final
+class NANO_API state_block final
 {
 public:
 	state_block () = default;
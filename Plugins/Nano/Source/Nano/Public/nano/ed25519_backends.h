@@ -0,0 +1,47 @@
+// Copyright 2020 Wesley Shillingford. All rights reserved.
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+namespace nano
+{
+/**
+ * ed25519-donna is compiled once per backend with its public functions suffixed, the one used is chosen at runtime.
+ * donna64 is ed25519.c as configured for this compiler, which falls back to 32-bit limbs without 128-bit multiplication.
+ */
+enum class ed25519_backend
+{
+	donna64,
+	sse2,
+	donna32
+};
+
+class ed25519_functions final
+{
+public:
+	void (*publickey) (unsigned char const * sk_a, unsigned char * pk_a);
+	void (*sign) (unsigned char const * m_a, size_t mlen_a, unsigned char const * sk_a, unsigned char const * pk_a, unsigned char * rs_a);
+	/** Returns 0 if the signature is valid */
+	int (*sign_open) (unsigned char const * m_a, size_t mlen_a, unsigned char const * pk_a, unsigned char const * rs_a);
+	int (*sign_open_batch) (unsigned char const ** m_a, size_t * mlen_a, unsigned char const ** pk_a, unsigned char const ** rs_a, size_t num_a, int * valid_a);
+};
+
+size_t constexpr ed25519_backend_count = 3;
+
+/** Compiled into this build and runnable on this cpu */
+bool ed25519_supported (nano::ed25519_backend backend_a);
+NANO_API char const * ed25519_backend_name (nano::ed25519_backend backend_a);
+/** Returns true if name_a isn't a supported backend */
+bool ed25519_backend_from_name (char const * name_a, nano::ed25519_backend & backend_a);
+
+/** Functions of the selected backend, which until something is selected is the best guess for this cpu */
+nano::ed25519_functions const & ed25519 ();
+NANO_API nano::ed25519_backend ed25519_selected ();
+/** Returns true if the backend isn't supported, leaving the selection unchanged */
+NANO_API bool ed25519_select (nano::ed25519_backend backend_a);
+
+/** Times signing and verifying with each supported backend and selects the fastest. Returns the signatures per second of
+ * each (sign and verify together), 0 for unsupported backends */
+std::array<double, nano::ed25519_backend_count> ed25519_select_fastest ();
+}
@@ -0,0 +1,171 @@
+// Copyright 2020 Wesley Shillingford. All rights reserved.
+#pragma once
+
+#include <nano/numbers.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace nano
+{
+/**
+ * Open addressing hash map keyed by 32 byte values such as accounts and block hashes. Keys and values live in flat arrays,
+ * collisions use linear probing and erasing shifts the following entries back so there are no tombstones.
+ * Value must be default constructible and movable. Pointers returned by find/emplace are invalidated by emplace and erase.
+ */
+template <typename Value>
+class key_map final
+{
+public:
+	Value * find (nano::uint256_union const & key_a)
+	{
+		auto index (locate (key_a));
+		return index != not_found ? &values[index] : nullptr;
+	}
+
+	Value const * find (nano::uint256_union const & key_a) const
+	{
+		auto index (locate (key_a));
+		return index != not_found ? &values[index] : nullptr;
+	}
+
+	/** Leaves an existing value alone, second is true if the value was inserted */
+	template <typename... Args>
+	std::pair<Value *, bool> emplace (nano::uint256_union const & key_a, Args &&... args_a)
+	{
+		auto existing (find (key_a));
+		if (existing != nullptr)
+		{
+			return { existing, false };
+		}
+		if ((count + 1) * 4 > keys.size () * 3)
+		{
+			rehash (keys.empty () ? 16 : keys.size () * 2);
+		}
+		auto index (insert_slot (key_a));
+		values[index] = Value (std::forward<Args> (args_a)...);
+		return { &values[index], true };
+	}
+
+	bool erase (nano::uint256_union const & key_a)
+	{
+		auto index (locate (key_a));
+		auto found (index != not_found);
+		if (found)
+		{
+			auto mask (keys.size () - 1);
+			// Pull back later entries of the same run which would no longer be reachable across the hole
+			for (auto next ((index + 1) & mask); occupied[next]; next = (next + 1) & mask)
+			{
+				auto home (slot (keys[next]));
+				if (((next - home) & mask) >= ((next - index) & mask))
+				{
+					keys[index] = keys[next];
+					values[index] = std::move (values[next]);
+					index = next;
+				}
+			}
+			occupied[index] = false;
+			values[index] = Value ();
+			--count;
+		}
+		return found;
+	}
+
+	void clear ()
+	{
+		keys.clear ();
+		occupied.clear ();
+		values.clear ();
+		count = 0;
+	}
+
+	size_t size () const
+	{
+		return count;
+	}
+
+	bool empty () const
+	{
+		return count == 0;
+	}
+
+	/** func_a (key, value), the map must not be modified while iterating */
+	template <typename Func>
+	void for_each (Func && func_a) const
+	{
+		for (size_t i (0); i < keys.size (); ++i)
+		{
+			if (occupied[i])
+			{
+				func_a (keys[i], values[i]);
+			}
+		}
+	}
+
+private:
+	static constexpr size_t not_found = static_cast<size_t> (-1);
+
+	size_t slot (nano::uint256_union const & key_a) const
+	{
+		// Fibonacci hashing, so keys which only differ in a few bits (or are text) still spread out
+		auto hash ((key_a.qwords[0] ^ key_a.qwords[1] ^ key_a.qwords[2] ^ key_a.qwords[3]) * 0x9e3779b97f4a7c15);
+		return static_cast<size_t> (hash >> 32) & (keys.size () - 1);
+	}
+
+	size_t locate (nano::uint256_union const & key_a) const
+	{
+		if (count != 0)
+		{
+			auto mask (keys.size () - 1);
+			for (auto index (slot (key_a)); occupied[index]; index = (index + 1) & mask)
+			{
+				if (keys[index] == key_a)
+				{
+					return index;
+				}
+			}
+		}
+		return not_found;
+	}
+
+	size_t insert_slot (nano::uint256_union const & key_a)
+	{
+		auto mask (keys.size () - 1);
+		auto index (slot (key_a));
+		while (occupied[index])
+		{
+			index = (index + 1) & mask;
+		}
+		keys[index] = key_a;
+		occupied[index] = true;
+		++count;
+		return index;
+	}
+
+	void rehash (size_t capacity_a)
+	{
+		std::vector<nano::uint256_union> old_keys (capacity_a);
+		std::vector<uint8_t> old_occupied (capacity_a, false);
+		std::vector<Value> old_values (capacity_a);
+		old_keys.swap (keys);
+		old_occupied.swap (occupied);
+		old_values.swap (values);
+		count = 0;
+		for (size_t i (0); i < old_keys.size (); ++i)
+		{
+			if (old_occupied[i])
+			{
+				values[insert_slot (old_keys[i])] = std::move (old_values[i]);
+			}
+		}
+	}
+
+	std::vector<nano::uint256_union> keys;
+	std::vector<uint8_t> occupied;
+	std::vector<Value> values;
+	size_t count{ 0 };
+};
+}
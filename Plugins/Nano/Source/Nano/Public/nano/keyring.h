@@ -0,0 +1,59 @@
+// Copyright 2020 Wesley Shillingford. All rights reserved.
+#pragma once
+
+#include <nano/key_map.h>
+#include <nano/numbers.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace nano
+{
+/**
+ * Private keys registered once with their public key and account derived up front, so signing with them again skips the
+ * scalar multiplication and the checksum. Entries live in one slab and are referred to by a 32-bit handle, the slot in the
+ * low 24 bits and the slot's generation in the high 8 so handles to a removed key stop resolving when its slot is reused.
+ * Registering a key again returns its handle and adds a reference. Not thread safe.
+ */
+class keyring final
+{
+public:
+	using handle = uint32_t;
+	/** No valid handle is ever 0 */
+	static handle constexpr invalid = 0;
+
+	class entry final
+	{
+	public:
+		nano::raw_key prv;
+		nano::public_key pub;
+		std::array<char, 65> account;
+	};
+
+	handle insert (nano::raw_key const & prv_a);
+	/** Adds a reference to a registered key, returns true if the handle isn't valid */
+	bool acquire (handle handle_a);
+	/** Drops a reference, the key is wiped once there are none. Returns true if the handle isn't valid */
+	bool erase (handle handle_a);
+	/** nullptr if the handle isn't valid, invalidated by insert */
+	entry const * find (handle handle_a) const;
+	/** The handle of a registered public key, invalid if it isn't registered */
+	handle find (nano::public_key const & pub_a) const;
+	size_t size () const;
+
+private:
+	class slot final
+	{
+	public:
+		nano::keyring::entry entry;
+		uint32_t references{ 0 };
+		uint8_t generation{ 1 };
+	};
+	slot * resolve (handle handle_a);
+	std::vector<slot> slots;
+	std::vector<uint32_t> free_slots;
+	nano::key_map<handle> handles;
+};
+}
@@ -0,0 +1,493 @@
+// Copyright 2020 Wesley Shillingford. All rights reserved.
+#pragma once
+
+#define _CRT_HAS_CXX17 0
+#ifdef _WIN32
+#pragma warning (disable : 4668 ) /* '__cplusplus' is not defined as a preprocessor macro, replacing with '0' for '#if/#elif' Caused by Windows SDK bug */
+#endif
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace nano
+{
+namespace detail
+{
+	/** 64 x 64 -> 128 bit multiply, returns the low half and writes the high half to high_a */
+	constexpr uint64_t mul_64x64 (uint64_t lhs_a, uint64_t rhs_a, uint64_t & high_a)
+	{
+#if defined(__SIZEOF_INT128__)
+		__extension__ using uint128_native = unsigned __int128;
+		auto product (static_cast<uint128_native> (lhs_a) * rhs_a);
+		high_a = static_cast<uint64_t> (product >> 64);
+		return static_cast<uint64_t> (product);
+#else
+		uint64_t lhs_lo (lhs_a & 0xffffffff), lhs_hi (lhs_a >> 32);
+		uint64_t rhs_lo (rhs_a & 0xffffffff), rhs_hi (rhs_a >> 32);
+		uint64_t lo_lo (lhs_lo * rhs_lo), hi_lo (lhs_hi * rhs_lo), lo_hi (lhs_lo * rhs_hi), hi_hi (lhs_hi * rhs_hi);
+		uint64_t cross ((lo_lo >> 32) + (hi_lo & 0xffffffff) + lo_hi);
+		high_a = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+		return (cross << 32) | (lo_lo & 0xffffffff);
+#endif
+	}
+
+	constexpr uint64_t load_be64 (uint8_t const * source_a)
+	{
+		return (uint64_t (source_a[0]) << 56) | (uint64_t (source_a[1]) << 48) | (uint64_t (source_a[2]) << 40) | (uint64_t (source_a[3]) << 32)
+		| (uint64_t (source_a[4]) << 24) | (uint64_t (source_a[5]) << 16) | (uint64_t (source_a[6]) << 8) | uint64_t (source_a[7]);
+	}
+
+	inline void store_be64 (uint8_t * destination_a, uint64_t value_a)
+	{
+		for (auto i (7); i >= 0; --i)
+		{
+			destination_a[i] = static_cast<uint8_t> (value_a);
+			value_a >>= 8;
+		}
+	}
+}
+
+/**
+ * Fixed width unsigned integer made from 64-bit limbs, least significant limb first.
+ * Arithmetic wraps modulo 2^bits like the builtin unsigned types, nothing here allocates.
+ */
+template <size_t bits_a>
+class fixed_uint final
+{
+	static_assert (bits_a > 0 && bits_a % 64 == 0, "fixed_uint width must be a multiple of 64 bits");
+
+public:
+	static constexpr size_t limb_count = bits_a / 64;
+
+	constexpr fixed_uint () = default;
+	constexpr fixed_uint (uint64_t value_a) :
+	limbs{ value_a }
+	{
+	}
+	/** Zero extends or truncates from another width */
+	template <size_t other_bits_a>
+	constexpr explicit fixed_uint (fixed_uint<other_bits_a> const & other_a)
+	{
+		for (size_t i (0); i < limb_count && i < fixed_uint<other_bits_a>::limb_count; ++i)
+		{
+			limbs[i] = other_a.limbs[i];
+		}
+	}
+
+	constexpr bool is_zero () const
+	{
+		uint64_t accumulate (0);
+		for (size_t i (0); i < limb_count; ++i)
+		{
+			accumulate |= limbs[i];
+		}
+		return accumulate == 0;
+	}
+
+	/** -1, 0 or 1 */
+	constexpr int compare (fixed_uint const & other_a) const
+	{
+		for (auto i (limb_count); i-- > 0;)
+		{
+			if (limbs[i] != other_a.limbs[i])
+			{
+				return limbs[i] < other_a.limbs[i] ? -1 : 1;
+			}
+		}
+		return 0;
+	}
+
+	/** Adds in place and returns the carry out of the top limb */
+	constexpr uint64_t add (fixed_uint const & other_a)
+	{
+		uint64_t carry (0);
+		for (size_t i (0); i < limb_count; ++i)
+		{
+			auto sum (limbs[i] + other_a.limbs[i]);
+			auto carry_l (static_cast<uint64_t> (sum < limbs[i]));
+			limbs[i] = sum + carry;
+			carry = carry_l | static_cast<uint64_t> (limbs[i] < sum);
+		}
+		return carry;
+	}
+
+	/** Subtracts in place and returns the borrow out of the top limb */
+	constexpr uint64_t subtract (fixed_uint const & other_a)
+	{
+		uint64_t borrow (0);
+		for (size_t i (0); i < limb_count; ++i)
+		{
+			auto difference (limbs[i] - other_a.limbs[i]);
+			auto borrow_l (static_cast<uint64_t> (difference > limbs[i]));
+			limbs[i] = difference - borrow;
+			borrow = borrow_l | static_cast<uint64_t> (limbs[i] > difference);
+		}
+		return borrow;
+	}
+
+	/** this = this * multiplier_a + addend_a, returns the limb which overflowed */
+	constexpr uint64_t multiply_add (uint64_t multiplier_a, uint64_t addend_a = 0)
+	{
+		auto carry (addend_a);
+		for (size_t i (0); i < limb_count; ++i)
+		{
+			uint64_t high (0);
+			auto low (detail::mul_64x64 (limbs[i], multiplier_a, high));
+			low += carry;
+			high += static_cast<uint64_t> (low < carry);
+			limbs[i] = low;
+			carry = high;
+		}
+		return carry;
+	}
+
+	/** Divides in place and returns the remainder */
+	constexpr uint32_t divide (uint32_t divisor_a)
+	{
+		uint64_t remainder (0);
+		for (auto i (limb_count); i-- > 0;)
+		{
+			auto high ((remainder << 32) | (limbs[i] >> 32));
+			remainder = high % divisor_a;
+			auto low ((remainder << 32) | (limbs[i] & 0xffffffff));
+			remainder = low % divisor_a;
+			limbs[i] = ((high / divisor_a) << 32) | (low / divisor_a);
+		}
+		return static_cast<uint32_t> (remainder);
+	}
+
+	constexpr fixed_uint & operator+= (fixed_uint const & other_a)
+	{
+		add (other_a);
+		return *this;
+	}
+	constexpr fixed_uint & operator-= (fixed_uint const & other_a)
+	{
+		subtract (other_a);
+		return *this;
+	}
+	constexpr fixed_uint & operator*= (fixed_uint const & other_a)
+	{
+		*this = *this * other_a;
+		return *this;
+	}
+	constexpr fixed_uint operator+ (fixed_uint const & other_a) const
+	{
+		auto result (*this);
+		result.add (other_a);
+		return result;
+	}
+	constexpr fixed_uint operator- (fixed_uint const & other_a) const
+	{
+		auto result (*this);
+		result.subtract (other_a);
+		return result;
+	}
+	/** Truncating schoolbook multiply */
+	constexpr fixed_uint operator* (fixed_uint const & other_a) const
+	{
+		fixed_uint result;
+		for (size_t i (0); i < limb_count; ++i)
+		{
+			uint64_t carry (0);
+			for (size_t j (0); i + j < limb_count; ++j)
+			{
+				uint64_t high (0);
+				auto low (detail::mul_64x64 (limbs[i], other_a.limbs[j], high));
+				low += carry;
+				high += static_cast<uint64_t> (low < carry);
+				result.limbs[i + j] += low;
+				high += static_cast<uint64_t> (result.limbs[i + j] < low);
+				carry = high;
+			}
+		}
+		return result;
+	}
+
+	constexpr fixed_uint & operator<<= (unsigned shift_a)
+	{
+		auto limb_shift (shift_a / 64);
+		auto bit_shift (shift_a % 64);
+		for (auto i (limb_count); i-- > 0;)
+		{
+			uint64_t value (0);
+			if (i >= limb_shift)
+			{
+				value = limbs[i - limb_shift] << bit_shift;
+				if (bit_shift != 0 && i > limb_shift)
+				{
+					value |= limbs[i - limb_shift - 1] >> (64 - bit_shift);
+				}
+			}
+			limbs[i] = value;
+		}
+		return *this;
+	}
+	constexpr fixed_uint & operator>>= (unsigned shift_a)
+	{
+		auto limb_shift (shift_a / 64);
+		auto bit_shift (shift_a % 64);
+		for (size_t i (0); i < limb_count; ++i)
+		{
+			uint64_t value (0);
+			if (i + limb_shift < limb_count)
+			{
+				value = limbs[i + limb_shift] >> bit_shift;
+				if (bit_shift != 0 && i + limb_shift + 1 < limb_count)
+				{
+					value |= limbs[i + limb_shift + 1] << (64 - bit_shift);
+				}
+			}
+			limbs[i] = value;
+		}
+		return *this;
+	}
+	constexpr fixed_uint operator<< (unsigned shift_a) const
+	{
+		auto result (*this);
+		result <<= shift_a;
+		return result;
+	}
+	constexpr fixed_uint operator>> (unsigned shift_a) const
+	{
+		auto result (*this);
+		result >>= shift_a;
+		return result;
+	}
+
+	constexpr fixed_uint & operator&= (fixed_uint const & other_a)
+	{
+		for (size_t i (0); i < limb_count; ++i)
+		{
+			limbs[i] &= other_a.limbs[i];
+		}
+		return *this;
+	}
+	constexpr fixed_uint & operator|= (fixed_uint const & other_a)
+	{
+		for (size_t i (0); i < limb_count; ++i)
+		{
+			limbs[i] |= other_a.limbs[i];
+		}
+		return *this;
+	}
+	constexpr fixed_uint & operator^= (fixed_uint const & other_a)
+	{
+		for (size_t i (0); i < limb_count; ++i)
+		{
+			limbs[i] ^= other_a.limbs[i];
+		}
+		return *this;
+	}
+	constexpr fixed_uint operator& (fixed_uint const & other_a) const
+	{
+		auto result (*this);
+		result &= other_a;
+		return result;
+	}
+	constexpr fixed_uint operator| (fixed_uint const & other_a) const
+	{
+		auto result (*this);
+		result |= other_a;
+		return result;
+	}
+	constexpr fixed_uint operator^ (fixed_uint const & other_a) const
+	{
+		auto result (*this);
+		result ^= other_a;
+		return result;
+	}
+	constexpr fixed_uint operator~ () const
+	{
+		fixed_uint result;
+		for (size_t i (0); i < limb_count; ++i)
+		{
+			result.limbs[i] = ~limbs[i];
+		}
+		return result;
+	}
+
+	constexpr bool operator== (fixed_uint const & other_a) const
+	{
+		return compare (other_a) == 0;
+	}
+	constexpr bool operator!= (fixed_uint const & other_a) const
+	{
+		return compare (other_a) != 0;
+	}
+	constexpr bool operator< (fixed_uint const & other_a) const
+	{
+		return compare (other_a) < 0;
+	}
+	constexpr bool operator> (fixed_uint const & other_a) const
+	{
+		return compare (other_a) > 0;
+	}
+	constexpr bool operator<= (fixed_uint const & other_a) const
+	{
+		return compare (other_a) <= 0;
+	}
+	constexpr bool operator>= (fixed_uint const & other_a) const
+	{
+		return compare (other_a) >= 0;
+	}
+
+	uint64_t limbs[limb_count]{};
+};
+
+using uint128_t = fixed_uint<128>;
+using uint256_t = fixed_uint<256>;
+using uint512_t = fixed_uint<512>;
+
+template <class number_t>
+constexpr number_t pow10 (unsigned exponent_a)
+{
+	number_t result (1);
+	for (auto i (0u); i < exponent_a; ++i)
+	{
+		result.multiply_add (10);
+	}
+	return result;
+}
+
+// SI dividers
+constexpr nano::uint128_t Gxrb_ratio = nano::pow10<nano::uint128_t> (33); // 10^33
+constexpr nano::uint128_t Mxrb_ratio = nano::pow10<nano::uint128_t> (30); // 10^30
+constexpr nano::uint128_t kxrb_ratio = nano::pow10<nano::uint128_t> (27); // 10^27
+constexpr nano::uint128_t xrb_ratio = nano::pow10<nano::uint128_t> (24); // 10^24
+constexpr nano::uint128_t raw_ratio = nano::uint128_t (1); // 10^0
+
+union NANO_API uint128_union final
+{
+public:
+	uint128_union () = default;
+	/**
+	 * Decode from hex string
+	 * @warning Aborts at runtime if the input is invalid
+	 */
+	uint128_union (std::string const &);
+	uint128_union (uint64_t);
+	uint128_union (nano::uint128_t const &);
+	bool operator== (nano::uint128_union const &) const;
+	bool operator!= (nano::uint128_union const &) const;
+	bool operator< (nano::uint128_union const &) const;
+	bool operator> (nano::uint128_union const &) const;
+	void encode_hex (std::string &) const;
+	void encode_hex (std::array<char, 32> &) const;
+	bool decode_hex (std::string const &);
+	void encode_dec (std::string &) const;
+	/** Returns the number of characters written */
+	size_t encode_dec (std::array<char, 39> &) const;
+	bool decode_dec (std::string const &, bool = false);
+	/** Decodes the first length characters of text, which need not be null terminated */
+	bool decode_dec_n (char const *, size_t, bool = false);
+	nano::uint128_t number () const;
+	void clear ();
+	bool is_zero () const;
+	std::string to_string () const;
+	std::string to_string_dec () const;
+	std::array<uint8_t, 16> bytes;
+	std::array<char, 16> chars;
+	std::array<uint32_t, 4> dwords;
+	std::array<uint64_t, 2> qwords;
+};
+// Balances are 128 bit.
+using amount = uint128_union;
+class raw_key;
+union NANO_API uint256_union final
+{
+	uint256_union () = default;
+	/**
+	 * Decode from hex string
+	 * @warning Aborts at runtime if the input is invalid
+	 */
+	uint256_union (std::string const &);
+	uint256_union (uint64_t);
+	uint256_union (nano::uint256_t const &);
+	void encrypt (nano::raw_key const &, nano::raw_key const &, uint128_union const &);
+	uint256_union & operator^= (nano::uint256_union const &);
+	uint256_union operator^ (nano::uint256_union const &) const;
+	bool operator== (nano::uint256_union const &) const;
+	bool operator!= (nano::uint256_union const &) const;
+	bool operator< (nano::uint256_union const &) const;
+	void encode_hex (std::string &) const;
+	void encode_hex (std::array<char, 64> &) const;
+	bool decode_hex (std::string const &);
+	bool decode_hex (char const *, size_t);
+	void encode_dec (std::string &) const;
+	bool decode_dec (std::string const &);
+	void encode_account (std::string &) const;
+	void encode_account (std::array<char, 65> &) const;
+	std::string to_account () const;
+	bool decode_account (std::string const &);
+	bool decode_account (char const *, size_t);
+	std::array<uint8_t, 32> bytes;
+	std::array<char, 32> chars;
+	std::array<uint32_t, 8> dwords;
+	std::array<uint64_t, 4> qwords;
+	std::array<uint128_union, 2> owords;
+	void clear ();
+	bool is_zero () const;
+	std::string to_string () const;
+	nano::uint256_t number () const;
+};
+// All keys and hashes are 256 bit.
+using block_hash = uint256_union;
+using account = uint256_union;
+using public_key = uint256_union;
+using private_key = uint256_union;
+using secret_key = uint256_union;
+class NANO_API raw_key final
+{
+public:
+	~raw_key ();
+	void decrypt (nano::uint256_union const &, nano::raw_key const &, uint128_union const &);
+	bool operator== (nano::raw_key const &) const;
+	bool operator!= (nano::raw_key const &) const;
+	nano::uint256_union data;
+};
+union NANO_API uint512_union final
+{
+	uint512_union () = default;
+	uint512_union (nano::uint256_union const &, nano::uint256_union const &);
+	uint512_union (nano::uint512_t const &);
+	bool operator== (nano::uint512_union const &) const;
+	bool operator!= (nano::uint512_union const &) const;
+	nano::uint512_union & operator^= (nano::uint512_union const &);
+	void encode_hex (std::string &) const;
+	void encode_hex (std::array<char, 128> &) const;
+	bool decode_hex (std::string const &);
+	bool decode_hex (char const *, size_t);
+	std::array<uint8_t, 64> bytes;
+	std::array<uint32_t, 16> dwords;
+	std::array<uint64_t, 8> qwords;
+	std::array<uint256_union, 2> uint256s;
+	void clear ();
+	bool is_zero () const;
+	nano::uint512_t number () const;
+	std::string to_string () const;
+};
+using signature = uint512_union;
+using qualified_root = uint512_union;
+
+NANO_API nano::uint512_union sign_message (nano::raw_key const &, nano::public_key const &, nano::uint256_union const &);
+NANO_API bool validate_message (nano::public_key const &, nano::uint256_union const &, nano::uint512_union const &);
+bool validate_message_batch (const unsigned char **, size_t *, const unsigned char **, const unsigned char **, size_t, int *);
+/** ed25519_sign_open_batch verifies up to this many signatures at once, so it is worth waiting for a batch this size */
+size_t constexpr signature_batch_size = 64;
+/** Verifies each hash was signed by the account at the same index, returns true for each valid signature */
+NANO_API std::vector<bool> validate_signatures (std::vector<nano::block_hash> const & hashes_a, std::vector<nano::account> const & accounts_a, std::vector<nano::signature> const & signatures_a);
+void deterministic_key (nano::uint256_union const &, uint32_t, nano::uint256_union &);
+/** deterministic_key for count_a consecutive indices from start_a, hashed several at a time by blake2b_many */
+void deterministic_keys (nano::uint256_union const & seed_a, uint32_t start_a, size_t count_a, nano::uint256_union * prv_a);
+NANO_API nano::public_key pub_key (nano::private_key const &);
+/** Writes count_a accounts with the nano_ prefix, the checksums are hashed several at a time by blake2b_many */
+void encode_accounts (nano::public_key const *, size_t, std::array<char, 65> *);
+
+/* Conversion methods */
+std::string to_string_hex (uint64_t const);
+bool from_string_hex (std::string const &, uint64_t &);
+}
\ No newline at end of file
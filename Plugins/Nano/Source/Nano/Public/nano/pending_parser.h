@@ -0,0 +1,36 @@
+// Copyright 2020 Wesley Shillingford. All rights reserved.
+#pragma once
+
+#include <nano/numbers.h>
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace nano
+{
+/** One receivable block from a pending response, amount and source are zero if the request didn't ask for them */
+class pending_entry final
+{
+public:
+	nano::block_hash hash;
+	nano::amount amount;
+	nano::account source;
+};
+
+/**
+ * Reads a pending rpc response in one pass without building a DOM, handing each block to visit_a as soon as it is read.
+ * visit_a returns true to stop, the rest of the response is then left unread. Blocks can come as hash: { amount, source },
+ * hash: amount, a list of hashes, or "" when there are none. Returns true on error, which includes an "error" response
+ */
+NANO_API bool parse_pending (char const * data_a, size_t size_a, std::function<bool (nano::pending_entry const &)> const & visit_a);
+
+/** Appends at most max_a blocks to entries_a, which callers can reserve once and reuse between responses */
+NANO_API bool parse_pending (char const * data_a, size_t size_a, std::vector<nano::pending_entry> & entries_a, size_t max_a = static_cast<size_t> (-1));
+
+/**
+ * Splits an accounts_pending response by account, visit_a (account, account_length, blocks, blocks_length) gets the text of
+ * each account's blocks. Wrapped as {"blocks":...} that is the account's own pending response. Returns true on error
+ */
+NANO_API bool parse_accounts_pending (char const * data_a, size_t size_a, std::function<void (char const *, size_t, char const *, size_t)> const & visit_a);
+}
@@ -0,0 +1,317 @@
+// Copyright 2020 Wesley Shillingford. All rights reserved.
+#pragma once
+
+#include <nano/blocks.h>
+#include <nano/numbers.h>
+#include <nano/work.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace nano
+{
+/**
+ * Writes json as UTF-8 straight to sink_a (char const *, size_t), so a request can be built in a reused byte buffer without
+ * a DOM. Only what the RPC requests need: nested objects, arrays and string, bool and binary fields, the binary ones encoded
+ * in place. Array elements are written with a null key.
+ */
+template <typename Sink>
+class json_writer final
+{
+public:
+	explicit json_writer (Sink sink_a) :
+	sink (sink_a)
+	{
+	}
+
+	/** Opens an object, as the value of key_a if it is inside another */
+	void begin (char const * key_a = nullptr)
+	{
+		if (key_a != nullptr)
+		{
+			key (key_a);
+		}
+		raw ("{", 1);
+		first = true;
+	}
+
+	void end ()
+	{
+		raw ("}", 1);
+		first = false;
+	}
+
+	void begin_array (char const * key_a)
+	{
+		key (key_a);
+		raw ("[", 1);
+		first = true;
+	}
+
+	void end_array ()
+	{
+		raw ("]", 1);
+		first = false;
+	}
+
+	/** Escapes the value, which comes from the caller */
+	void string (char const * key_a, char const * value_a, size_t length_a)
+	{
+		key (key_a);
+		raw ("\"", 1);
+		auto start (value_a);
+		for (auto i (value_a), end (value_a + length_a); i != end; ++i)
+		{
+			auto c (static_cast<uint8_t> (*i));
+			if (c == '"' || c == '\\' || c < 0x20)
+			{
+				raw (start, i - start);
+				char escaped[6] = { '\\', 'u', '0', '0', hex_digit (c >> 4), hex_digit (c & 0xf) };
+				raw (escaped, sizeof (escaped));
+				start = i + 1;
+			}
+		}
+		raw (start, value_a + length_a - start);
+		raw ("\"", 1);
+	}
+
+	void string (char const * key_a, char const * value_a)
+	{
+		string (key_a, value_a, std::strlen (value_a));
+	}
+
+	void boolean (char const * key_a, bool value_a)
+	{
+		key (key_a);
+		value_a ? raw ("true", 4) : raw ("false", 5);
+	}
+
+	/** A decimal number as a string, which is how the node takes counts */
+	void number (char const * key_a, uint64_t value_a)
+	{
+		char text[20];
+		auto begin (text + sizeof (text));
+		do
+		{
+			*--begin = static_cast<char> ('0' + value_a % 10);
+			value_a /= 10;
+		} while (value_a != 0);
+		quoted (key_a, begin, text + sizeof (text) - begin);
+	}
+
+	void hex (char const * key_a, nano::uint256_union const & value_a)
+	{
+		std::array<char, 64> text;
+		value_a.encode_hex (text);
+		quoted (key_a, text.data (), text.size ());
+	}
+
+	void hex (char const * key_a, nano::uint512_union const & value_a)
+	{
+		std::array<char, 128> text;
+		value_a.encode_hex (text);
+		quoted (key_a, text.data (), text.size ());
+	}
+
+	void account (char const * key_a, nano::account const & value_a)
+	{
+		std::array<char, 65> text;
+		value_a.encode_account (text);
+		quoted (key_a, text.data (), text.size ());
+	}
+
+	/** In raw, as a decimal */
+	void amount (char const * key_a, nano::amount const & value_a)
+	{
+		std::array<char, 39> text;
+		auto length (value_a.encode_dec (text));
+		quoted (key_a, text.data (), length);
+	}
+
+	void work (char const * key_a, uint64_t value_a)
+	{
+		std::array<char, 16> text;
+		nano::encode_work (value_a, text);
+		quoted (key_a, text.data (), text.size ());
+	}
+
+private:
+	static char hex_digit (uint8_t value_a)
+	{
+		return "0123456789abcdef"[value_a];
+	}
+
+	void raw (char const * data_a, size_t size_a)
+	{
+		sink (data_a, size_a);
+	}
+
+	void key (char const * key_a)
+	{
+		if (!first)
+		{
+			raw (",", 1);
+		}
+		first = false;
+		if (key_a != nullptr)
+		{
+			raw ("\"", 1);
+			raw (key_a, std::strlen (key_a));
+			raw ("\":", 2);
+		}
+	}
+
+	/** A string value which needs no escaping */
+	void quoted (char const * key_a, char const * value_a, size_t length_a)
+	{
+		key (key_a);
+		raw ("\"", 1);
+		raw (value_a, length_a);
+		raw ("\"", 1);
+	}
+
+	Sink sink;
+	bool first{ true };
+};
+
+template <typename Sink>
+nano::json_writer<Sink> make_json_writer (Sink sink_a)
+{
+	return nano::json_writer<Sink> (sink_a);
+}
+
+/** The requests the plugin makes most, written the same way the node documents them. Strings are UTF-8 */
+namespace rpc
+{
+	template <typename Sink>
+	void account_balance (nano::json_writer<Sink> & writer_a, char const * account_a, size_t account_length_a)
+	{
+		writer_a.begin ();
+		writer_a.string ("action", "account_balance");
+		writer_a.string ("account", account_a, account_length_a);
+		writer_a.boolean ("include_only_confirmed", true);
+		writer_a.end ();
+	}
+
+	template <typename Sink>
+	void account_info (nano::json_writer<Sink> & writer_a, char const * account_a, size_t account_length_a)
+	{
+		writer_a.begin ();
+		writer_a.string ("action", "account_info");
+		writer_a.string ("account", account_a, account_length_a);
+		writer_a.string ("representative", "true");
+		writer_a.string ("pending", "true");
+		writer_a.boolean ("include_confirmed", true);
+		writer_a.end ();
+	}
+
+	/** threshold_a is in raw */
+	template <typename Sink>
+	void pending (nano::json_writer<Sink> & writer_a, char const * account_a, size_t account_length_a, uint64_t count_a, char const * threshold_a, size_t threshold_length_a)
+	{
+		writer_a.begin ();
+		writer_a.string ("action", "pending");
+		writer_a.string ("account", account_a, account_length_a);
+		writer_a.string ("sort", "true");
+		writer_a.string ("source", "true");
+		writer_a.string ("include_only_confirmed", "true");
+		writer_a.number ("count", count_a);
+		writer_a.string ("threshold", threshold_a, threshold_length_a);
+		writer_a.end ();
+	}
+
+	template <typename Sink>
+	void work_generate (nano::json_writer<Sink> & writer_a, nano::block_hash const & root_a, uint64_t difficulty_a)
+	{
+		writer_a.begin ();
+		writer_a.string ("action", "work_generate");
+		writer_a.hex ("hash", root_a);
+		writer_a.work ("difficulty", difficulty_a);
+		writer_a.end ();
+	}
+
+	template <typename Sink>
+	void block_info (nano::json_writer<Sink> & writer_a, char const * hash_a, size_t hash_length_a)
+	{
+		writer_a.begin ();
+		writer_a.string ("action", "block_info");
+		writer_a.boolean ("json_block", true);
+		writer_a.string ("hash", hash_a, hash_length_a);
+		writer_a.end ();
+	}
+
+	template <typename Sink>
+	void process (nano::json_writer<Sink> & writer_a, nano::state_hashables const & block_a, nano::signature const & signature_a, uint64_t work_a)
+	{
+		writer_a.begin ();
+		writer_a.string ("action", "process");
+		writer_a.string ("json_block", "true");
+		writer_a.begin ("block");
+		writer_a.string ("type", "state");
+		writer_a.account ("account", block_a.account);
+		writer_a.hex ("previous", block_a.previous);
+		writer_a.account ("representative", block_a.representative);
+		writer_a.amount ("balance", block_a.balance);
+		writer_a.hex ("link", block_a.link);
+		writer_a.hex ("signature", signature_a);
+		writer_a.work ("work", work_a);
+		writer_a.end ();
+		writer_a.end ();
+	}
+
+	/** accounts_balances, accounts_frontiers or accounts_representatives */
+	template <typename Sink>
+	void accounts (nano::json_writer<Sink> & writer_a, char const * action_a, nano::account const * accounts_a, size_t count_a, bool include_only_confirmed_a)
+	{
+		writer_a.begin ();
+		writer_a.string ("action", action_a);
+		writer_a.begin_array ("accounts");
+		for (size_t i (0); i < count_a; ++i)
+		{
+			writer_a.account (nullptr, accounts_a[i]);
+		}
+		writer_a.end_array ();
+		writer_a.boolean ("include_only_confirmed", include_only_confirmed_a);
+		writer_a.end ();
+	}
+
+	/** The options match pending, so each account's blocks are what pending would have returned */
+	template <typename Sink>
+	void accounts_pending (nano::json_writer<Sink> & writer_a, nano::account const * accounts_a, size_t count_a, uint64_t count_per_account_a, char const * threshold_a, size_t threshold_length_a)
+	{
+		writer_a.begin ();
+		writer_a.string ("action", "accounts_pending");
+		writer_a.begin_array ("accounts");
+		for (size_t i (0); i < count_a; ++i)
+		{
+			writer_a.account (nullptr, accounts_a[i]);
+		}
+		writer_a.end_array ();
+		writer_a.string ("sort", "true");
+		writer_a.string ("source", "true");
+		writer_a.string ("include_only_confirmed", "true");
+		writer_a.number ("count", count_per_account_a);
+		writer_a.string ("threshold", threshold_a, threshold_length_a);
+		writer_a.end ();
+	}
+
+	/** Hashes the node doesn't have are listed in blocks_not_found rather than failing the request */
+	template <typename Sink>
+	void blocks_info (nano::json_writer<Sink> & writer_a, nano::block_hash const * hashes_a, size_t count_a)
+	{
+		writer_a.begin ();
+		writer_a.string ("action", "blocks_info");
+		writer_a.boolean ("json_block", true);
+		writer_a.boolean ("include_not_found", true);
+		writer_a.begin_array ("hashes");
+		for (size_t i (0); i < count_a; ++i)
+		{
+			writer_a.hex (nullptr, hashes_a[i]);
+		}
+		writer_a.end_array ();
+		writer_a.end ();
+	}
+}
+}
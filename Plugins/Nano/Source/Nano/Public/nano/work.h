@@ -0,0 +1,109 @@
+// Copyright 2020 Wesley Shillingford. All rights reserved.
+#pragma once
+
+#include <nano/numbers.h>
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace nano
+{
+/** Minimum difficulties accepted by the live network */
+namespace work_thresholds
+{
+	uint64_t constexpr epoch_1 = 0xffffffc000000000;
+	/** Sends and changes once the account is upgraded to epoch 2 */
+	uint64_t constexpr epoch_2 = 0xfffffff800000000;
+	/** Receives and opens once the account is upgraded to epoch 2 */
+	uint64_t constexpr epoch_2_receive = 0xfffffe0000000000;
+}
+
+/** How many times more work difficulty_a takes than base_a on average, the node reports multipliers against epoch_2 */
+double work_multiplier (uint64_t difficulty_a, uint64_t base_a = nano::work_thresholds::epoch_2);
+/** The difficulty multiplier_a times harder than base_a, the inverse of work_multiplier */
+uint64_t work_difficulty (double multiplier_a, uint64_t base_a = nano::work_thresholds::epoch_2);
+
+/** Difficulty of work_a for root_a, the 8 byte blake2b digest of (work_a || root_a) read as little endian */
+NANO_API uint64_t work_value (nano::block_hash const & root_a, uint64_t work_a);
+
+/** Returns true if work_a does not reach threshold_a for root_a */
+bool work_validate (nano::block_hash const & root_a, uint64_t work_a, uint64_t threshold_a);
+
+/** errors_a[i] = work_validate (roots_a[i], works_a[i], threshold_a) */
+void work_validate (nano::block_hash const * roots_a, uint64_t const * works_a, size_t count_a, uint64_t threshold_a, bool * errors_a);
+
+/**
+ * Work hashing specialised for its single 40 byte block: the parameter block and zero message words are folded away and the
+ * rounds unrolled. The SIMD kernels hash one nonce per 64-bit lane, 2 with SSE4.1 and 4 with AVX2.
+ */
+enum class work_kernel
+{
+	scalar,
+	sse41,
+	avx2
+};
+
+/** Widest kernel this cpu supports */
+NANO_API nano::work_kernel best_work_kernel ();
+
+/** values_a[i] = work_value (root_a, nonces_a[i]) for each of count_a nonces, kernel_a must be supported by the cpu */
+NANO_API void work_values (nano::work_kernel kernel_a, nano::block_hash const & root_a, uint64_t const * nonces_a, uint64_t * values_a, size_t count_a);
+void work_values (nano::block_hash const & root_a, uint64_t const * nonces_a, uint64_t * values_a, size_t count_a);
+
+/** Work as the 16 hex digits used by the RPC */
+void encode_work (uint64_t work_a, std::array<char, 16> & text_a);
+
+/** Parses up to 16 hex digits, returns true on error and work_a is untouched */
+bool decode_work (char const * text_a, size_t length_a, uint64_t & work_a);
+
+/**
+ * Generates work on a set of CPU threads. Requests are served in order, all threads search for the front one from different
+ * random nonces and the first to pass the difficulty wins.
+ */
+class work_pool final
+{
+public:
+	/** callback_a (cancelled, work) */
+	using callback_type = std::function<void (bool, uint64_t)>;
+
+	/** threads_a of 0 leaves one hardware thread free */
+	explicit work_pool (unsigned threads_a);
+	~work_pool ();
+
+	/** callback_a is called on a worker thread, or on the cancelling thread if the request is cancelled */
+	void generate (nano::block_hash const & root_a, uint64_t difficulty_a, callback_type callback_a);
+	void cancel (nano::block_hash const & root_a);
+	/** Cancels everything outstanding and joins the threads */
+	void stop ();
+	size_t size ();
+	size_t thread_count () const;
+	/** Nonces tried since construction, poll it to show progress */
+	uint64_t attempts () const;
+
+private:
+	class item final
+	{
+	public:
+		nano::block_hash root;
+		uint64_t difficulty;
+		callback_type callback;
+	};
+
+	void loop (uint64_t thread_a);
+
+	std::deque<item> pending;
+	std::mutex mutex;
+	std::condition_variable producer_condition;
+	std::atomic<int> ticket{ 0 };
+	std::atomic<uint64_t> attempted{ 0 };
+	bool done{ false };
+	std::vector<std::thread> threads;
+};
+}
@@ -0,0 +1,63 @@
+// Copyright 2020 Wesley Shillingford. All rights reserved.
+#pragma once
+
+#include <nano/key_map.h>
+#include <nano/numbers.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace nano
+{
+/**
+ * Work indexed by root, kept in memory and mirrored by an append only file. The file is a header followed by fixed size records of
+ * root, work, difficulty and a checksum, so a record torn by a crash is detected and dropped along with anything after it.
+ * Later records replace earlier ones and a difficulty of 0 removes the root. This class only produces and replays the bytes,
+ * the caller does the file io.
+ */
+class NANO_API work_cache final
+{
+public:
+	static size_t constexpr header_size = 8;
+	static size_t constexpr record_size = 56;
+	using record = std::array<uint8_t, record_size>;
+
+	class entry final
+	{
+	public:
+		uint64_t work{ 0 };
+		uint64_t difficulty{ 0 };
+	};
+
+	/**
+	 * Replaces the contents with the records in a file
+	 * @return Number of leading bytes which were valid, the file should be rewritten if this is less than size_a
+	 */
+	size_t load (uint8_t const * data_a, size_t size_a);
+
+	entry const * find (nano::block_hash const & root_a) const;
+
+	/** Writes the record to append to the file into record_a */
+	void insert (nano::block_hash const & root_a, uint64_t work_a, uint64_t difficulty_a, record & record_a);
+
+	/** @return true if the root was cached, only then is record_a written */
+	bool erase (nano::block_hash const & root_a, record & record_a);
+
+	/** A whole file holding just the live entries, which should replace the current one */
+	std::vector<uint8_t> compact ();
+
+	/** True once most of the records in the file are superseded */
+	bool needs_compaction () const;
+
+	size_t size () const;
+
+	/** Start of every file */
+	static std::array<uint8_t, header_size> const header;
+
+private:
+	nano::key_map<entry> entries;
+	size_t records{ 0 };
+};
+}
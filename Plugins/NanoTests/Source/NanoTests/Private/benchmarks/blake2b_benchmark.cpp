@@ -0,0 +1,77 @@
+// Copyright 2020 Wesley Shillingford. All rights reserved.
+#include "HAL/PlatformTime.h"
+#include "Misc/AutomationTest.h"
+
+#include <nano/blake2b.h>
+#include <nano/numbers.h>
+
+#include <array>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace {
+constexpr auto hashes = 1000000;
+
+// Single threaded, the messages are the 36 bytes of seed || index hashed for each seed account
+template <typename Func>
+double HashesPerSecond(Func&& func) {
+	auto start = FPlatformTime::Seconds();
+	for (auto i = 0; i < hashes; i += 4) {
+		func(i);
+	}
+	return hashes / (FPlatformTime::Seconds() - start);
+}
+
+const TCHAR* KernelName(nano::blake2b_kernel kernel) {
+	switch (kernel) {
+		case nano::blake2b_kernel::avx2:
+			return TEXT("avx2");
+		case nano::blake2b_kernel::sse41:
+			return TEXT("sse4.1");
+		default:
+			return TEXT("scalar");
+	}
+}
+}	 // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNanoBlake2bBenchmark, "Nano.Benchmarks.Blake2b",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FNanoBlake2bBenchmark::RunTest(const FString& Parameters) {
+	std::array<std::array<uint8_t, 36>, 4> messages{};
+	std::array<std::array<uint8_t, 32>, 4> digests;
+	uint8_t* out[4] = {digests[0].data(), digests[1].data(), digests[2].data(), digests[3].data()};
+	const uint8_t* in[4] = {messages[0].data(), messages[1].data(), messages[2].data(), messages[3].data()};
+
+	auto selected = nano::blake2b_selected();
+	for (auto kernel : {nano::blake2b_kernel::scalar, nano::blake2b_kernel::sse41, nano::blake2b_kernel::avx2}) {
+		if (nano::blake2b_select(kernel)) {
+			AddInfo(FString::Printf(TEXT("%s: not supported by this cpu"), KernelName(kernel)));
+			continue;
+		}
+		auto single = HashesPerSecond([&](int i) {
+			for (auto lane = 0; lane < 4; ++lane) {
+				messages[lane][35] = static_cast<uint8_t>(i + lane);
+				// A single message always goes through blake2b
+				nano::blake2b_many(out + lane, 32, in + lane, 36, 1);
+			}
+		});
+		auto many = HashesPerSecond([&](int i) {
+			for (auto lane = 0; lane < 4; ++lane) {
+				messages[lane][35] = static_cast<uint8_t>(i + lane);
+			}
+			nano::blake2b_many(out, 32, in, 36, 4);
+		});
+		AddInfo(FString::Printf(TEXT("%s: blake2b %.0f hashes/s, blake2b_many %.0f hashes/s per core%s"), KernelName(kernel),
+			single, many, kernel == selected ? TEXT(" (selected)") : TEXT("")));
+
+		std::array<uint8_t, 32> expected;
+		uint8_t* expectedOut[1] = {expected.data()};
+		nano::blake2b_many(expectedOut, expected.size(), in + 3, 36, 1);
+		TestTrue(TEXT("blake2b_many matches blake2b"), digests[3] == expected);
+	}
+	nano::blake2b_select(selected);
+	return true;
+}
+
+#endif
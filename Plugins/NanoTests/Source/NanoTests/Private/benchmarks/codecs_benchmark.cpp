@@ -0,0 +1,96 @@
+// Copyright 2020 Wesley Shillingford. All rights reserved.
+#include "HAL/PlatformTime.h"
+#include "Misc/AutomationTest.h"
+
+#include <nano/numbers.h>
+
+#include <array>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace {
+constexpr auto iterations = 100000;
+
+template <typename Func>
+double NanosecondsPerOp(Func&& func) {
+	auto start = FPlatformTime::Seconds();
+	for (auto i = 0; i < iterations; ++i) {
+		func(i);
+	}
+	return (FPlatformTime::Seconds() - start) * 1e9 / iterations;
+}
+}	 // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNanoCodecsBenchmark, "Nano.Benchmarks.Codecs",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FNanoCodecsBenchmark::RunTest(const FString& Parameters) {
+	const std::string maxRaw = "340282366920938463463374607431768211455";
+	nano::amount amount;
+	amount.decode_dec(maxRaw);
+	nano::uint256_union hash;
+	hash.decode_hex("64E4A5F0098E9330224975EB51D227BDDAD1E999E9AA2910B4724D78024CACF4");
+	const auto hashHex = hash.to_string();
+
+	size_t sink = 0;
+	auto report = [this](const TCHAR* name, double legacy, double current) {
+		AddInfo(FString::Printf(TEXT("%s: %.1f ns/op before, %.1f ns/op now (%.1fx)"), name, legacy, current, legacy / current));
+	};
+
+	// BaseConverter, which these replaced, is no longer built so the decimal codecs are reported on their own
+	auto current = NanosecondsPerOp([&](int i) {
+		nano::amount parsed;
+		sink += parsed.decode_dec_n(maxRaw.data(), maxRaw.size() - (i & 1)) ? 0 : parsed.bytes[15];
+	});
+	AddInfo(FString::Printf(TEXT("Decimal decode (128-bit): %.1f ns/op"), current));
+
+	current = NanosecondsPerOp([&](int i) {
+		std::array<char, 39> text;
+		amount.qwords[0] ^= i & 1;
+		sink += amount.encode_dec(text);
+	});
+	AddInfo(FString::Printf(TEXT("Decimal encode (128-bit): %.1f ns/op"), current));
+
+	// Upstream nano-node formats through iostreams
+	auto legacy = NanosecondsPerOp([&](int) {
+		std::stringstream stream;
+		stream << std::hex << std::uppercase << std::setfill('0');
+		for (auto byte : hash.bytes) {
+			stream << std::setw(2) << static_cast<unsigned>(byte);
+		}
+		sink += stream.str().size();
+	});
+	current = NanosecondsPerOp([&](int i) {
+		std::array<char, 64> text;
+		hash.bytes[0] ^= i & 1;
+		hash.encode_hex(text);
+		sink += text[0];
+	});
+	report(TEXT("Hex encode (256-bit)"), legacy, current);
+
+	legacy = NanosecondsPerOp([&](int) {
+		std::stringstream stream(hashHex);
+		stream << std::hex << std::noshowbase;
+		nano::uint256_union parsed;
+		for (auto& byte : parsed.bytes) {
+			char pair[3] = {};
+			stream.read(pair, 2);
+			byte = static_cast<uint8_t>(std::strtoul(pair, nullptr, 16));
+		}
+		sink += parsed.bytes[31];
+	});
+	current = NanosecondsPerOp([&](int) {
+		nano::uint256_union parsed;
+		sink += parsed.decode_hex(hashHex.data(), hashHex.size()) ? 0 : parsed.bytes[31];
+	});
+	report(TEXT("Hex decode (256-bit)"), legacy, current);
+
+	TestTrue(TEXT("Benchmarks ran"), sink != 0);
+	return true;
+}
+
+#endif
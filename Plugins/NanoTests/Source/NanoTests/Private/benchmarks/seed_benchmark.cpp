@@ -0,0 +1,34 @@
+// Copyright 2020 Wesley Shillingford. All rights reserved.
+#include "HAL/PlatformTime.h"
+#include "Misc/AutomationTest.h"
+#include "NanoBlueprintLibrary.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNanoSeedBenchmark, "Nano.Benchmarks.Seed",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FNanoSeedBenchmark::RunTest(const FString& Parameters) {
+	const FString seed = TEXT("34F0A37AAD20F4A260F0A5B3CB3D7FB50673212263E58A380BC10474BB039CE4");
+
+	// What scanning indices used to cost, one AccountFromSeed per index
+	constexpr auto singleCount = 1000;
+	auto start = FPlatformTime::Seconds();
+	FString last;
+	for (auto i = 0; i < singleCount; ++i) {
+		last = UNanoBlueprintLibrary::AccountFromSeed(seed, i);
+	}
+	auto single = singleCount / (FPlatformTime::Seconds() - start);
+	AddInfo(FString::Printf(TEXT("AccountFromSeed: %.0f accounts/s"), single));
+
+	for (auto count : {1000, 100000}) {
+		start = FPlatformTime::Seconds();
+		auto range = UNanoBlueprintLibrary::AccountsFromSeedRange(seed, 0, count);
+		auto rate = count / (FPlatformTime::Seconds() - start);
+		AddInfo(FString::Printf(TEXT("AccountsFromSeedRange %d: %.0f accounts/s (%.1fx)"), count, rate, rate / single));
+		TestTrue(TEXT("Range matches"), range.accounts.Num() == count && range.accounts[singleCount - 1] == last);
+	}
+	return true;
+}
+
+#endif
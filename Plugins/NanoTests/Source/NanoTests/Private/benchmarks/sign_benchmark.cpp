@@ -0,0 +1,76 @@
+// Copyright 2020 Wesley Shillingford. All rights reserved.
+#include "HAL/PlatformTime.h"
+#include "Misc/AutomationTest.h"
+
+#include <nano/blocks.h>
+#include <nano/ed25519_backends.h>
+#include <nano/numbers.h>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace {
+constexpr auto signatures = 20000;
+
+// Single threaded, so this is the rate of one core
+template <typename Func>
+double SignaturesPerSecond(Func&& func) {
+	auto start = FPlatformTime::Seconds();
+	for (auto i = 0; i < signatures; ++i) {
+		func(i);
+	}
+	return signatures / (FPlatformTime::Seconds() - start);
+}
+}	 // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNanoSignBenchmark, "Nano.Benchmarks.Sign",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FNanoSignBenchmark::RunTest(const FString& Parameters) {
+	nano::raw_key prv;
+	prv.data.decode_hex("34F0A37AAD20F4A260F0A5B3CB3D7FB50673212263E58A380BC10474BB039CE4");
+	auto pub = nano::pub_key(prv.data);
+
+	nano::uint256_union message;
+	message.decode_hex("E89208DD038FBB269987689621D52292AE9C35941A7484756ECCED92A65093BA");
+
+	nano::signature signature;
+	auto sign = SignaturesPerSecond([&](int i) {
+		message.qwords[0] = i;
+		signature = nano::sign_message(prv, pub, message);
+	});
+	AddInfo(FString::Printf(TEXT("sign_message: %.0f signatures/s per core"), sign));
+	TestFalse(TEXT("Signature valid"), nano::validate_message(pub, message, signature));
+
+	// What a payout costs before it is sent to the node, hashing and signing a state block
+	nano::amount balance(0);
+	auto blocks = SignaturesPerSecond([&](int i) {
+		balance.qwords[1] = i;
+		nano::state_block block(pub, message, pub, balance, message, prv, pub);
+		signature = block.block_signature();
+	});
+	AddInfo(FString::Printf(TEXT("state_block: %.0f blocks/s per core"), blocks));
+
+	auto verify = SignaturesPerSecond([&](int) { nano::validate_message(pub, message, signature); });
+	AddInfo(FString::Printf(TEXT("validate_message: %.0f signatures/s per core"), verify));
+
+	auto selected = nano::ed25519_selected();
+	for (size_t index = 0; index < nano::ed25519_backend_count; ++index) {
+		auto backend = static_cast<nano::ed25519_backend>(index);
+		FString name = UTF8_TO_TCHAR(nano::ed25519_backend_name(backend));
+		if (nano::ed25519_select(backend)) {
+			AddInfo(FString::Printf(TEXT("%s: not supported by this cpu"), *name));
+			continue;
+		}
+		auto rate = SignaturesPerSecond([&](int i) {
+			message.qwords[0] = i;
+			signature = nano::sign_message(prv, pub, message);
+		});
+		AddInfo(FString::Printf(TEXT("%s sign_message: %.0f signatures/s per core%s"), *name, rate,
+			backend == selected ? TEXT(" (selected)") : TEXT("")));
+		TestFalse(TEXT("Backend signature valid"), nano::validate_message(pub, message, signature));
+	}
+	nano::ed25519_select(selected);
+	return true;
+}
+
+#endif
@@ -0,0 +1,63 @@
+// Copyright 2020 Wesley Shillingford. All rights reserved.
+#include "HAL/PlatformTime.h"
+#include "Misc/AutomationTest.h"
+
+#include <nano/work.h>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace {
+constexpr auto hashes = 1 << 20;
+
+// Single threaded, so this is the rate of one core
+template <typename Func>
+double MegahashesPerSecond(Func&& func) {
+	auto start = FPlatformTime::Seconds();
+	for (auto i = 0; i < hashes; i += 8) {
+		func(i);
+	}
+	return hashes / (FPlatformTime::Seconds() - start) / 1e6;
+}
+}	 // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNanoWorkBenchmark, "Nano.Benchmarks.Work",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FNanoWorkBenchmark::RunTest(const FString& Parameters) {
+	nano::block_hash root;
+	root.decode_hex("E89208DD038FBB269987689621D52292AE9C35941A7484756ECCED92A65093BA");
+
+	uint64_t sink = 0;
+	auto reference = MegahashesPerSecond([&](int i) {
+		for (auto j = 0; j < 8; ++j) {
+			sink += nano::work_value(root, i + j);
+		}
+	});
+	AddInfo(FString::Printf(TEXT("Reference blake2b: %.2f MH/s per core"), reference));
+
+	auto kernels = {nano::work_kernel::scalar, nano::work_kernel::sse41, nano::work_kernel::avx2};
+	const TCHAR* names[] = {TEXT("Scalar"), TEXT("SSE4.1 (2 lanes)"), TEXT("AVX2 (4 lanes)")};
+	auto best = static_cast<int>(nano::best_work_kernel());
+	for (auto kernel : kernels) {
+		auto index = static_cast<int>(kernel);
+		if (index > best) {
+			AddInfo(FString::Printf(TEXT("%s: not supported by this cpu"), names[index]));
+			continue;
+		}
+		auto rate = MegahashesPerSecond([&](int i) {
+			uint64_t nonces[8];
+			uint64_t values[8];
+			for (auto j = 0; j < 8; ++j) {
+				nonces[j] = i + j;
+			}
+			nano::work_values(kernel, root, nonces, values, 8);
+			sink += values[0];
+		});
+		AddInfo(FString::Printf(TEXT("%s: %.2f MH/s per core (%.1fx)"), names[index], rate, rate / reference));
+	}
+
+	TestTrue(TEXT("Benchmarks ran"), sink != 0);
+	return true;
+}
+
+#endif
@@ -2,8 +2,14 @@
 #include "NanoBlueprintLibrary.h"
 
 #include <Misc/AutomationTest.h>
+#include <nano/pending_parser.h>
+#include <nano/work.h>
+#include <nano/work_cache.h>
 
+#include <algorithm>
 #include <string>
+#include <utility>
+#include <vector>
 
 #if WITH_DEV_AUTOMATION_TESTS
 
@@ -19,12 +25,19 @@ bool FNanoBlueprintLibraryTest::RunTest(const FString& Parameters) {
 	TestTrue(TEXT("Exact nano nano number"), UNanoBlueprintLibrary::ValidateNano(".1223"));
 	TestFalse(TEXT("Exact nano nano number"), UNanoBlueprintLibrary::ValidateNano(".122.3"));
 	TestTrue(TEXT("Exact nano nano number"), UNanoBlueprintLibrary::ValidateNano(",1223"));
+	TestFalse(TEXT("More than 30 fractional digits"), UNanoBlueprintLibrary::ValidateNano("1.999999999999999999999999999999999"));
 
 	TestTrue(TEXT("100 raw is valid"), UNanoBlueprintLibrary::ValidateRaw("100"));
 	TestTrue(TEXT("Exactly max raw supply"), UNanoBlueprintLibrary::ValidateRaw("340282366920938463463374607431768211455"));
 	TestFalse(TEXT("Invalid characters raw, decimal not allowed"), UNanoBlueprintLibrary::ValidateRaw("100.123"));
 	TestFalse(TEXT("Invalid characters raw"), UNanoBlueprintLibrary::ValidateRaw("100@123"));
 	TestTrue(TEXT("Leading zeroes are ok"), UNanoBlueprintLibrary::ValidateRaw("0001"));
+	TestTrue(TEXT("Leading zeroes don't count towards the length"),
+		UNanoBlueprintLibrary::ValidateRaw("000340282366920938463463374607431768211455"));
+	FNanoAmount padded;
+	TestFalse(TEXT("Zero padded raw amount"), FNanoAmount::FromRaw("0000000000000000000000000000000000000000100", padded));
+	TestEqual(TEXT("Zero padded raw amount value"), padded.ToRaw(), TEXT("100"));
+	TestTrue(TEXT("40 digits without leading zeroes"), FNanoAmount::FromRaw("1000000000000000000000000000000000000000", padded));
 	TestFalse(
 		TEXT("A lot above max"), UNanoBlueprintLibrary::ValidateRaw("1111111111111111111111111111111111111111111111111111111111"));
 	TestFalse(TEXT("1 above max raw supply"), UNanoBlueprintLibrary::ValidateRaw("340282366920938463463374607431768211456"));
@@ -102,10 +115,14 @@ bool FNanoBlueprintLibraryTest::RunTest(const FString& Parameters) {
 	// Add
 	auto op = UNanoBlueprintLibrary::Add(UNanoBlueprintLibrary::NanoToRaw("1"), UNanoBlueprintLibrary::NanoToRaw("2"));
 	TestEqual(TEXT("1Nano + 2Nano (as raw)"), op, UNanoBlueprintLibrary::NanoToRaw("3"));
+	op = UNanoBlueprintLibrary::Add(TEXT("340282366920938463463374607431768211454"), TEXT("1"));
+	TestEqual(TEXT("Add up to max raw supply"), op, TEXT("340282366920938463463374607431768211455"));
 
 	// Subtract
 	op = UNanoBlueprintLibrary::Subtract(UNanoBlueprintLibrary::NanoToRaw("2"), UNanoBlueprintLibrary::NanoToRaw("1"));
 	TestEqual(TEXT("2Nano - 1Nano (as raw)"), op, UNanoBlueprintLibrary::NanoToRaw("1"));
+	op = UNanoBlueprintLibrary::Subtract(TEXT("18446744073709551616"), TEXT("1"));
+	TestEqual(TEXT("Subtract borrows across 64-bit limbs"), op, TEXT("18446744073709551615"));
 
 	// Returns true if raw is greater than baseRaw
 	TestEqual(TEXT("raw Greater1"), true, UNanoBlueprintLibrary::Greater("3000", "2000"));
@@ -116,8 +133,30 @@ bool FNanoBlueprintLibraryTest::RunTest(const FString& Parameters) {
 	TestEqual(TEXT("raw GreaterOrEqual2"), true, UNanoBlueprintLibrary::GreaterOrEqual("2000", "2000"));
 	TestEqual(TEXT("raw GreaterOrEqual3"), false, UNanoBlueprintLibrary::GreaterOrEqual("1999", "2000"));
 
+	auto maxAmount = UNanoBlueprintLibrary::AmountFromRaw("340282366920938463463374607431768211455");
+	TestEqual(TEXT("Amount round trip"), UNanoBlueprintLibrary::AmountToRaw(maxAmount), TEXT("340282366920938463463374607431768211455"));
+	TestTrue(TEXT("Amount invalid"), UNanoBlueprintLibrary::AmountFromRaw("340282366920938463463374607431768211456").IsZero());
+	auto carry = UNanoBlueprintLibrary::Add_AmountAmount(
+		UNanoBlueprintLibrary::AmountFromRaw("18446744073709551615"), UNanoBlueprintLibrary::AmountFromRaw("1"));
+	TestEqual(TEXT("Amount add carry"), UNanoBlueprintLibrary::AmountToRaw(carry), TEXT("18446744073709551616"));
+	TestEqual(TEXT("Amount subtract borrow"),
+		UNanoBlueprintLibrary::AmountToRaw(UNanoBlueprintLibrary::Subtract_AmountAmount(carry, UNanoBlueprintLibrary::AmountFromRaw("1"))),
+		TEXT("18446744073709551615"));
+	TestTrue(TEXT("Amount greater"), UNanoBlueprintLibrary::Greater_AmountAmount(carry, UNanoBlueprintLibrary::AmountFromRaw("1")));
+	TestFalse(TEXT("Amount less"), UNanoBlueprintLibrary::Less_AmountAmount(maxAmount, carry));
+
+	TArray<FNanoAmount> amounts{UNanoBlueprintLibrary::AmountFromRaw("3000"), UNanoBlueprintLibrary::AmountFromRaw("1000"),
+		UNanoBlueprintLibrary::AmountFromRaw("2000")};
+	int32 index;
+	TestEqual(TEXT("Amount sum"), UNanoBlueprintLibrary::AmountToRaw(UNanoBlueprintLibrary::SumAmounts(amounts)), TEXT("6000"));
+	TestEqual(TEXT("Amount min"), UNanoBlueprintLibrary::AmountToRaw(UNanoBlueprintLibrary::MinAmount(amounts, index)), TEXT("1000"));
+	TestEqual(TEXT("Amount min index"), index, 1);
+	TestEqual(TEXT("Amount max"), UNanoBlueprintLibrary::AmountToRaw(UNanoBlueprintLibrary::MaxAmount(amounts, index)), TEXT("3000"));
+	TestEqual(TEXT("Amount max index"), index, 0);
+
 	TestEqual(TEXT("Create seed length"), 64, UNanoBlueprintLibrary::CreateSeed().Len());
 	TestNotEqual(TEXT("Create seed check"), FString(std::string(64, '0').c_str()), UNanoBlueprintLibrary::CreateSeed());
+	TestNotEqual(TEXT("Create seed unique"), UNanoBlueprintLibrary::CreateSeed(), UNanoBlueprintLibrary::CreateSeed());
 
 	auto seed = TEXT("1234567891234567891234567891234567891234567891234567891234567891");
 	auto privateKey = TEXT("64E4A5F0098E9330224975EB51D227BDDAD1E999E9AA2910B4724D78024CACF4");
@@ -126,15 +165,37 @@ bool FNanoBlueprintLibraryTest::RunTest(const FString& Parameters) {
 		UNanoBlueprintLibrary::PublicKeyFromSeed(seed, 0));
 	TestEqual(TEXT("AccountFromSeed"), TEXT("nano_18s4jwxeztcijasjm3unf34xnba6bo6f764amn1op8jsgb7aquz9ke8njujm"),
 		UNanoBlueprintLibrary::AccountFromSeed(seed, 0));
+	// Crosses a chunk boundary
+	auto range = UNanoBlueprintLibrary::AccountsFromSeedRange(seed, 0, 300);
+	TestTrue(TEXT("AccountsFromSeedRange"), range.accounts.Num() == 300 && range.privateKeys[0] == privateKey &&
+		range.accounts[0] == UNanoBlueprintLibrary::AccountFromSeed(seed, 0) &&
+		range.publicKeys[299] == UNanoBlueprintLibrary::PublicKeyFromSeed(seed, 299) &&
+		range.accounts[299] == UNanoBlueprintLibrary::AccountFromSeed(seed, 299));
+	TestEqual(TEXT("AccountsFromSeedRange invalid seed"), 0, UNanoBlueprintLibrary::AccountsFromSeedRange("seed", 0, 1).accounts.Num());
+	TestEqual(TEXT("AccountsFromSeedRange above the maximum count"), 0,
+		UNanoBlueprintLibrary::AccountsFromSeedRange(seed, 0, (1 << 20) + 1).accounts.Num());
 	TestEqual(TEXT("AccountFromPublicKey"), TEXT("nano_18s4jwxeztcijasjm3unf34xnba6bo6f764amn1op8jsgb7aquz9ke8njujm"),
 		UNanoBlueprintLibrary::AccountFromPublicKey("1B228F3ACFE9508A331987746845DA25044D48D290489D015B1A39724A8BEFE7"));
 	TestEqual(TEXT("PublicKeyFromAccount"), TEXT("1B228F3ACFE9508A331987746845DA25044D48D290489D015B1A39724A8BEFE7"),
 		UNanoBlueprintLibrary::PublicKeyFromAccount("nano_18s4jwxeztcijasjm3unf34xnba6bo6f764amn1op8jsgb7aquz9ke8njujm"));
+	TestEqual(TEXT("PublicKeyFromAccount xrb_ prefix"), TEXT("1B228F3ACFE9508A331987746845DA25044D48D290489D015B1A39724A8BEFE7"),
+		UNanoBlueprintLibrary::PublicKeyFromAccount("xrb_18s4jwxeztcijasjm3unf34xnba6bo6f764amn1op8jsgb7aquz9ke8njujm"));
+	TestEqual(TEXT("PublicKeyFromAccount bad checksum"), TEXT("0000000000000000000000000000000000000000000000000000000000000000"),
+		UNanoBlueprintLibrary::PublicKeyFromAccount("nano_18s4jwxeztcijasjm3unf34xnba6bo6f764amn1op8jsgb7aquz9ke8njujn"));
 	TestEqual(TEXT("PublicKeyFromPrivateKey"), TEXT("1B228F3ACFE9508A331987746845DA25044D48D290489D015B1A39724A8BEFE7"),
 		UNanoBlueprintLibrary::PublicKeyFromPrivateKey(privateKey));
 	TestEqual(TEXT("AccountFromPrivateKey"), TEXT("nano_18s4jwxeztcijasjm3unf34xnba6bo6f764amn1op8jsgb7aquz9ke8njujm"),
 		UNanoBlueprintLibrary::AccountFromPrivateKey(privateKey));
 
+	// Work of the live genesis open block, its value is fffffff4000d3dac
+	auto genesis = TEXT("E89208DD038FBB269987689621D52292AE9C35941A7484756ECCED92A65093BA");
+	TestTrue(TEXT("ValidateWork"), UNanoBlueprintLibrary::ValidateWork(genesis, "62f05417dd3fb691", "ffffffc000000000"));
+	TestFalse(TEXT("ValidateWork send threshold"), UNanoBlueprintLibrary::ValidateWork(genesis, "62f05417dd3fb691"));
+	TestFalse(TEXT("ValidateWork wrong work"), UNanoBlueprintLibrary::ValidateWork(genesis, "62f05417dd3fb692", "ffffffc000000000"));
+	auto validWork = UNanoBlueprintLibrary::ValidateWorkBatch(
+		{genesis, genesis, "not hex"}, {"62f05417dd3fb691", "0", "62f05417dd3fb691"}, "ffffffc000000000");
+	TestTrue(TEXT("ValidateWorkBatch"), validWork.Num() == 3 && validWork[0] && !validWork[1] && !validWork[2]);
+
 	TestEqual(
 		TEXT("SHA256"), TEXT("4c79de09ef123e2834dbe06d420158e455ac658aeb181da3b3ca5aabaf02dea3"), UNanoBlueprintLibrary::SHA256(seed));
 
@@ -146,4 +207,177 @@ bool FNanoBlueprintLibraryTest::RunTest(const FString& Parameters) {
 	return true;
 }
 
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNanoPendingParserTest, "NanoPendingParser",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+bool FNanoPendingParserTest::RunTest(const FString& Parameters) {
+	const std::string hash1(64, 'A');
+	const std::string hash2(64, 'B');
+	const std::string source = "nano_3t6k35gi95xu6tergt6p69ck76ogmitsa8mnijtpxm9fkcm736xtoncuohr3";
+	const std::string response = "{\"blocks\": {\"" + hash1 + "\": {\"amount\": \"1000\", \"source\": \"" + source +
+								 "\"}, \"" + hash2 + "\": {\"amount\": \"5\", \"source\": \"" + source + "\"}}}";
+
+	std::vector<nano::pending_entry> entries;
+	TestFalse(TEXT("parse_pending"), nano::parse_pending(response.data(), response.size(), entries));
+	TestTrue(TEXT("parse_pending blocks"), entries.size() == 2 && entries[0].hash.to_string() == hash1 &&
+											   entries[0].amount.number() == 1000 && entries[0].source.to_account() == source &&
+											   entries[1].hash.to_string() == hash2 && entries[1].amount.number() == 5);
+
+	const std::string none = "{\"blocks\": \"\"}";
+	entries.clear();
+	TestFalse(TEXT("parse_pending no blocks"), nano::parse_pending(none.data(), none.size(), entries));
+	TestTrue(TEXT("parse_pending no blocks empty"), entries.empty());
+
+	// Stopping leaves the rest unread, so it doesn't matter that it is cut short
+	auto visited = 0;
+	auto cut = response.substr(0, response.find(hash2) + 10);
+	TestFalse(TEXT("parse_pending early stop"), nano::parse_pending(cut.data(), cut.size(), [&visited](nano::pending_entry const&) {
+		++visited;
+		return true;
+	}));
+	TestEqual(TEXT("parse_pending early stop visits one"), visited, 1);
+	entries.clear();
+	TestFalse(TEXT("parse_pending max"), nano::parse_pending(response.data(), response.size(), entries, 1));
+	TestEqual(TEXT("parse_pending max count"), static_cast<int32>(entries.size()), 1);
+
+	entries.clear();
+	TestTrue(TEXT("parse_pending truncated"), nano::parse_pending(cut.data(), cut.size(), entries));
+	auto unclosed = response.substr(0, response.size() - 1);
+	TestTrue(TEXT("parse_pending unclosed"), nano::parse_pending(unclosed.data(), unclosed.size(), entries));
+	const std::string error = "{\"error\": \"Bad account number\"}";
+	TestTrue(TEXT("parse_pending error"), nano::parse_pending(error.data(), error.size(), entries));
+	const std::string missing = "{}";
+	TestTrue(TEXT("parse_pending without blocks"), nano::parse_pending(missing.data(), missing.size(), entries));
+
+	// accounts_pending as batched by the manager, each account's blocks become its own pending response
+	const std::string account = "nano_18s4jwxeztcijasjm3unf34xnba6bo6f764amn1op8jsgb7aquz9ke8njujm";
+	const std::string batched = "{\"blocks\": {\"" + source + "\": {\"" + hash1 + "\": {\"amount\": \"7\", \"source\": \"" +
+								source + "\"}}, \"xrb_" + account.substr(5) + "\": \"\"}}";
+	std::vector<std::pair<nano::account, std::string>> accounts;
+	auto decoded = true;
+	TestFalse(TEXT("parse_accounts_pending"),
+		nano::parse_accounts_pending(batched.data(), batched.size(),
+			[&accounts, &decoded](char const* text, size_t length, char const* blocks, size_t blocksLength) {
+				nano::account key;
+				decoded = decoded && !key.decode_account(text, length);
+				accounts.emplace_back(key, "{\"blocks\":" + std::string(blocks, blocksLength) + "}");
+			}));
+	nano::account sourceKey;
+	nano::account accountKey;
+	sourceKey.decode_account(source);
+	accountKey.decode_account(account);
+	TestTrue(TEXT("parse_accounts_pending accounts"), decoded && accounts.size() == 2 && accounts[0].first == sourceKey);
+	TestTrue(TEXT("parse_accounts_pending xrb_ prefix"), accounts.size() == 2 && accounts[1].first == accountKey);
+	// Accounts left out of the response aren't visited, the manager answers them with no blocks
+	TestFalse(TEXT("parse_accounts_pending missing account"),
+		std::any_of(accounts.begin(), accounts.end(),
+			[](std::pair<nano::account, std::string> const& entry) { return entry.first == nano::account(1); }));
+	if (accounts.size() == 2) {
+		entries.clear();
+		auto const& blocks = accounts[0].second;
+		TestFalse(TEXT("parse_accounts_pending blocks"), nano::parse_pending(blocks.data(), blocks.size(), entries));
+		TestTrue(TEXT("parse_accounts_pending blocks read"), entries.size() == 1 && entries[0].amount.number() == 7);
+		entries.clear();
+		auto const& empty = accounts[1].second;
+		TestFalse(TEXT("parse_accounts_pending empty blocks"), nano::parse_pending(empty.data(), empty.size(), entries));
+		TestTrue(TEXT("parse_accounts_pending empty blocks read"), entries.empty());
+	}
+
+	auto truncated = batched.substr(0, batched.size() - 8);
+	TestTrue(TEXT("parse_accounts_pending truncated"),
+		nano::parse_accounts_pending(truncated.data(), truncated.size(), [](char const*, size_t, char const*, size_t) {}));
+	TestTrue(TEXT("parse_accounts_pending error"),
+		nano::parse_accounts_pending(error.data(), error.size(), [](char const*, size_t, char const*, size_t) {}));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNanoWorkCacheTest, "NanoWorkCache",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+bool FNanoWorkCacheTest::RunTest(const FString& Parameters) {
+	nano::block_hash root1(1);
+	nano::block_hash root2(2);
+	nano::block_hash root3(3);
+
+	// The file as the manager writes it, the header then a record per change
+	nano::work_cache cache;
+	std::vector<uint8_t> file(nano::work_cache::header.begin(), nano::work_cache::header.end());
+	nano::work_cache::record record;
+	auto append = [&file, &record]() { file.insert(file.end(), record.begin(), record.end()); };
+	cache.insert(root1, 1, 10, record);
+	append();
+	cache.insert(root2, 2, 20, record);
+	append();
+	TestTrue(TEXT("work_cache erase"), cache.erase(root1, record));
+	append();
+	TestFalse(TEXT("work_cache erase missing"), cache.erase(root3, record));
+
+	nano::work_cache loaded;
+	TestTrue(TEXT("work_cache load"), loaded.load(file.data(), file.size()) == file.size());
+	TestTrue(TEXT("work_cache tombstone"), loaded.size() == 1 && loaded.find(root1) == nullptr);
+	auto entry = loaded.find(root2);
+	TestTrue(TEXT("work_cache entry"), entry && entry->work == 2 && entry->difficulty == 20);
+
+	// A crash part way through appending a record leaves a torn tail, which is dropped
+	auto complete = file.size();
+	loaded.insert(root3, 3, 30, record);
+	file.insert(file.end(), record.begin(), record.begin() + nano::work_cache::record_size / 2);
+	TestTrue(TEXT("work_cache torn tail"), loaded.load(file.data(), file.size()) == complete);
+	TestTrue(TEXT("work_cache torn tail dropped"), loaded.size() == 1 && loaded.find(root3) == nullptr && loaded.find(root2));
+
+	// A record that fails its checksum ends the file, so the tombstone after it is lost too
+	file.resize(complete);
+	file[nano::work_cache::header_size + nano::work_cache::record_size] ^= 1;
+	TestTrue(TEXT("work_cache checksum"),
+		loaded.load(file.data(), file.size()) == nano::work_cache::header_size + nano::work_cache::record_size);
+	TestTrue(TEXT("work_cache checksum dropped"), loaded.size() == 1 && loaded.find(root1) && loaded.find(root2) == nullptr);
+	file[0] ^= 1;
+	TestTrue(TEXT("work_cache header"), loaded.load(file.data(), file.size()) == 0);
+
+	// Compacting keeps only the live entries
+	for (auto i = 0; i < 40; ++i) {
+		cache.insert(root3, 3, 30, record);
+		cache.erase(root3, record);
+	}
+	TestTrue(TEXT("work_cache needs compaction"), cache.needs_compaction());
+	auto compacted = cache.compact();
+	TestFalse(TEXT("work_cache compacted"), cache.needs_compaction());
+	TestTrue(TEXT("work_cache compact size"), compacted.size() == nano::work_cache::header_size + nano::work_cache::record_size);
+	TestTrue(TEXT("work_cache compact load"), loaded.load(compacted.data(), compacted.size()) == compacted.size());
+	entry = loaded.find(root2);
+	TestTrue(TEXT("work_cache compact entry"), loaded.size() == 1 && entry && entry->work == 2 && entry->difficulty == 20);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNanoWorkKernelTest, "NanoWorkKernel",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+bool FNanoWorkKernelTest::RunTest(const FString& Parameters) {
+	// The live genesis block, its work is a known answer for the hash
+	nano::block_hash genesis("E89208DD038FBB269987689621D52292AE9C35941A7484756ECCED92A65093BA");
+	uint64_t const genesisWork = 0x62f05417dd3fb691;
+	uint64_t const genesisValue = 0xfffffff4000d3dac;
+	TestTrue(TEXT("work_value genesis"), nano::work_value(genesis, genesisWork) == genesisValue);
+
+	// 13 covers full SSE4.1 and AVX2 groups and a remainder for each
+	std::vector<uint64_t> nonces;
+	for (uint64_t i = 0; i < 13; ++i) {
+		nonces.push_back(genesisWork + i * 0x9e3779b97f4a7c15);
+	}
+	auto best = static_cast<int>(nano::best_work_kernel());
+	for (auto kernel = static_cast<int>(nano::work_kernel::scalar); kernel <= best; ++kernel) {
+		auto kernelName = FString::Printf(TEXT("work_values kernel %d"), kernel);
+		std::vector<uint64_t> values(nonces.size());
+		nano::work_values(static_cast<nano::work_kernel>(kernel), genesis, nonces.data(), values.data(), nonces.size());
+		for (size_t i = 0; i < nonces.size(); ++i) {
+			TestTrue(kernelName, values[i] == nano::work_value(genesis, nonces[i]));
+		}
+
+		uint64_t value = 0;
+		nano::work_values(static_cast<nano::work_kernel>(kernel), genesis, &genesisWork, &value, 1);
+		TestTrue(kernelName + TEXT(" genesis"), value == genesisValue);
+	}
+	return true;
+}
+
 #endif	// WITH_DEV_AUTOMATION_TESTS
@@ -103,6 +103,13 @@ app.post("/", (req, res) => {
     "pending",
     "process",
     "work_generate",
+    // Sampled by the manager when dynamicWorkDifficulty is set
+    "active_difficulty",
+    // Looked up in batches by the block ingestor, and by the manager when rpcBatchWindow is set
+    "accounts_balances",
+    "accounts_frontiers",
+    "accounts_pending",
+    "blocks_info",
   ];
   // This is an optional action for development/faucet purposes
   if (action == "request_nano") {